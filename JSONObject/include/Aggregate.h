@@ -0,0 +1,66 @@
+/* ------------------------------------------*/
+/* Filename: Aggregate.h                     */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __AGGREGATE_H__
+#define __AGGREGATE_H__
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): aggregates over the numbers of an array, or over one field across
+     * an array of objects. packed s32/f64 arrays and the columns of TABLE arrays are
+     * contiguous, they are run through AVX2 kernels when the cpu has them and through
+     * scalar kernels otherwise. GENERIC arrays are gathered into a small buffer of
+     * doubles first and run through the same kernels.
+     *
+     * the scalar kernels sum in the same lanes and order as the AVX2 ones, both give
+     * the same bits for the same array. elements that are not numbers are skipped, so
+     * are rows without the field. nan is not handled, a nan in the input makes the
+     * result undefined.
+     *
+     * usage:   Summary x0 = Summarize(pairs, x0_key);
+     *          f64 mean = x0.Mean();
+     */
+    enum class AggregateKernel
+    {
+        BEST,       // AVX2 if the cpu has it, SCALAR otherwise
+        SCALAR,
+        AVX2        // falls back to SCALAR on a cpu without AVX2
+    };
+
+    struct Summary
+    {
+        u64 count;
+        f64 sum;
+        f64 min;    // +inf if count is 0
+        f64 max;    // -inf if count is 0
+
+        f64 Mean() const { return count ? sum / count : 0; }
+    };
+
+    /**
+     * @return 1 if the AVX2 kernels are compiled in and the cpu runs them
+     */
+    b8 HasAVX2Kernels();
+
+    Summary Summarize(const JSONArray& arr, AggregateKernel kernel = AggregateKernel::BEST);
+    Summary Summarize(const JSONArray& arr, const Key& key, AggregateKernel kernel = AggregateKernel::BEST);
+
+    /**
+     * @brief counts the numbers in [low, high) into bins.Size() bins of equal width. the
+     *        counts are added to bins, so one histogram can cover several arrays
+     * @return number of values counted, values outside of [low, high) are not
+     */
+    u64 Histogram(const JSONArray& arr, f64 low, f64 high, Span<u64> bins,
+                  AggregateKernel kernel = AggregateKernel::BEST);
+    u64 Histogram(const JSONArray& arr, const Key& key, f64 low, f64 high, Span<u64> bins,
+                  AggregateKernel kernel = AggregateKernel::BEST);
+}
+
+#endif /* __AGGREGATE_H__ */
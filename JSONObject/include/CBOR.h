@@ -0,0 +1,92 @@
+/* ------------------------------------------*/
+/* Filename: CBOR.h                          */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __CBOR_H__
+#define __CBOR_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): binary encoding of a document as CBOR (RFC 8949).
+     *
+     *  INT             -> unsigned / negative integer, shortest head
+     *  DOUBLE          -> float32 when that is exact, float64 otherwise
+     *  STR, KEY        -> text string
+     *  JSON_OBJECT     -> map with text string keys, in insertion order
+     *  ARR             -> array, packed arrays are written straight from their storage
+     *  NULL, BAD_TYPE  -> null
+     *
+     * everything is definite length, so any CBOR decoder can read the output.
+     */
+    class CBOREncoder
+    {
+    public:
+        void Encode(const JSONObject& obj);
+        void Encode(const JSONObject::JSONValue& value);
+
+        const std::vector<u8>& Bytes() const { return bytes; }
+        void Clear() { bytes.clear(); }
+
+    private:
+        std::vector<u8> bytes;
+
+        void EncodeObject(const JSONObject& obj);
+        void EncodeArray(const JSONObject::JSONArray& arr);
+        void EncodeInt(s64 num);
+        void EncodeDouble(f64 num);
+        void EncodeString(std::string_view str);
+        void EncodeHead(u8 major_type, u64 argument);
+    };
+
+    /**
+     * NOTE(19.10.26): builds the DOM straight from the bytes, there is no token pass.
+     * besides what CBOREncoder writes it accepts indefinite length arrays and maps,
+     * half floats, booleans (as INT 1 and 0, there is no bool type) and integers out
+     * of s32 range (as DOUBLE). tags are skipped, byte strings and undefined fail.
+     */
+    class CBORDecoder
+    {
+    public:
+        static const u32 max_depth = 512;
+
+        /**
+         * @return the decoded object, or an empty object if the input is not a valid
+         *         CBOR map. Good() tells the two apart
+         */
+        JSONObject Decode(const u8 *data, u64 size);
+        JSONObject Decode(const std::vector<u8>& data) { return Decode(data.data(), data.size()); }
+
+        b8 Good() const { return !failed; }
+
+    private:
+        const u8 *at;
+        const u8 *end;
+        u32 depth;
+        b8 failed;
+
+        JSONObject::JSONValue DecodeValue();
+        JSONObject::JSONValue DecodeObject(u8 info);
+        JSONObject::JSONValue DecodeArray(u8 info);
+
+        /**
+         * @brief reads the argument that follows an initial byte with additional info 'info'
+         */
+        b8 ReadArgument(u8 info, u64& argument);
+        b8 ReadString(u8 initial, std::string& str);
+        b8 IsBreak();
+
+        JSONObject::JSONValue Fail();
+    };
+}
+
+#endif /* __CBOR_H__ */
@@ -0,0 +1,137 @@
+/* ------------------------------------------*/
+/* Filename: ConcurrentObject.h              */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __CONCURRENT_OBJECT_H__
+#define __CONCURRENT_OBJECT_H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): a key value store many threads read and update at once. the key
+     * space is split by the high bits of the key hash into shards, each one a JSONObject
+     * behind its own reader writer lock. threads working on different keys rarely meet
+     * on a lock, readers of one shard share it. the low bits still index the members
+     * inside the shard.
+     *
+     * values go in and come out by copy, a reference into a shard would outlive the
+     * lock. copying an object or an array is O(1), the bodies are shared copy on write,
+     * so a reader holding a copy never sees a later write.
+     *
+     * insertion order across shards is optional, with Order::INSERTION every new key
+     * gets a sequence number and ToObject returns the members in that order. it costs
+     * a second map per shard, the default keeps only the order inside each shard.
+     *
+     * usage:   ConcurrentObject state;
+     *          state.Put("jobs_done", 0);
+     *          state.Update("jobs_done", [](JSONValue& value) { value = (s32)value + 1; });
+     */
+    class ConcurrentObject
+    {
+    public:
+        enum class Order
+        {
+            UNORDERED,
+            INSERTION
+        };
+
+        static const u64 default_num_shards = 64;
+
+        /**
+         * @param num_shards rounded up to a power of two
+         */
+        explicit ConcurrentObject(u64 num_shards = default_num_shards, Order order = Order::UNORDERED);
+
+        ConcurrentObject(const ConcurrentObject& other) = delete;
+        ConcurrentObject& operator=(const ConcurrentObject& other) = delete;
+
+        /**
+         * @brief inserts key or replaces its value
+         */
+        void Put(std::string key, JSONValue value);
+
+        /**
+         * @brief copies the value of key into out
+         * @return 1 if key was found, 0 otherwise and out is left unchanged
+         */
+        b8 Get(std::string_view key, JSONValue& out) const;
+        b8 Get(const Key& key, JSONValue& out) const;
+
+        b8 Contains(std::string_view key) const;
+
+        /**
+         * @return 1 if key was removed, 0 if it wasn't there
+         */
+        b8 Remove(std::string_view key);
+
+        /**
+         * @brief calls fn(JSONValue&) on the value of key under the lock of its shard,
+         *        so a read, modify, write is atomic. a missing key is inserted with a
+         *        NULL_TYPE value first. fn must not call back into this object
+         */
+        template<typename Fn>
+        void Update(std::string key, Fn&& fn);
+
+        /**
+         * @return number of keys, shards are counted one after another
+         */
+        u64 Size() const;
+
+        /**
+         * @brief copies the members into a regular object. every shard is consistent on
+         *        its own, writes to other shards can land while the copy is made
+         */
+        JSONObject ToObject() const;
+
+    private:
+        // NOTE(19.10.26): one shard per cache line pair, the locks of neighbouring shards
+        // must not share a line
+        struct alignas(128) Shard
+        {
+            mutable std::shared_mutex mutex;
+            JSONObject members;
+            std::unordered_map<std::string, u64> sequences;     // Order::INSERTION only
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        u64 num_shards;
+        u64 shard_mask;
+        Order order;
+        std::atomic<u64> next_sequence;
+
+        Shard& ShardOf(u64 hash) const { return shards[(hash >> 32) & shard_mask]; }
+
+        template<typename K>
+        b8 Find(u64 hash, const K& key, JSONValue& out) const;
+
+        /**
+         * @return the value of key, inserted as NULL_TYPE if it is new. the shard's
+         *         lock must be held exclusively
+         */
+        JSONValue& Slot(Shard& shard, std::string&& key);
+    };
+
+    template<typename Fn>
+    void ConcurrentObject::Update(std::string key, Fn&& fn)
+    {
+        Shard& shard = ShardOf(HashKey(key));
+        std::lock_guard<std::shared_mutex> lock(shard.mutex);
+        fn(Slot(shard, std::move(key)));
+    }
+}
+
+#endif /* __CONCURRENT_OBJECT_H__ */
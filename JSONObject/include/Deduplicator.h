@@ -0,0 +1,77 @@
+/* ------------------------------------------*/
+/* Filename: Deduplicator.h                  */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __DEDUPLICATOR_H__
+#define __DEDUPLICATOR_H__
+
+#include <unordered_map>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): hash-conses objects and arrays while a document is built. a
+     * container that is identical to one seen before (same members in the same order,
+     * same values) is replaced with a copy of the first one, and the two share a body.
+     * shared bodies are copy on write, so mutating either copy later detaches it and
+     * the other one is unaffected.
+     *
+     * containers have to be interned bottom up, children before their parent, the way
+     * the parser builds them. then every child is already canonical and two candidates
+     * are compared one level deep, children by body identity.
+     *
+     * usage:   Deduplicator dedup;
+     *          JSONObject obj = parser.Parse(json_str, dedup);
+     *          dedup.GetStats().bytes_saved;
+     */
+    class Deduplicator
+    {
+    public:
+        struct Stats
+        {
+            u64 containers_seen;
+            u64 containers_shared;
+            u64 bytes_saved;        // heap bytes of the dropped copies
+        };
+
+        Deduplicator() : stats() {}
+
+        /**
+         * @brief replaces value with its canonical copy if one exists, otherwise makes
+         *        value the canonical copy. values that are not containers are left alone
+         */
+        void Intern(JSONObject::JSONValue& value);
+
+        const Stats& GetStats() const { return stats; }
+
+        /**
+         * @brief drops the table, documents that were built keep their sharing
+         */
+        void Clear();
+
+    private:
+        Stats stats;
+
+        // NOTE(19.10.26): holding the canonical values keeps their bodies alive, so a
+        // body address in body_hashes can't be reused by another body
+        std::unordered_multimap<u64, JSONObject::JSONValue> canonical;
+        std::unordered_map<const void*, u64> body_hashes;
+
+        u64 HashValue(const JSONObject::JSONValue& value) const;
+        u64 HashObject(const JSONObject& obj) const;
+        u64 HashArray(const JSONObject::JSONArray& arr) const;
+
+        static const void* BodyOf(const JSONObject::JSONValue& value);
+        static b8 SameValue(const JSONObject::JSONValue& lhs, const JSONObject::JSONValue& rhs);
+        static b8 SameObject(const JSONObject& lhs, const JSONObject& rhs);
+        static b8 SameArray(const JSONObject::JSONArray& lhs, const JSONObject::JSONArray& rhs);
+        static u64 ShallowBytes(const JSONObject::JSONValue& value);
+    };
+}
+
+#endif /* __DEDUPLICATOR_H__ */
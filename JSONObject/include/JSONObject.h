@@ -8,21 +8,112 @@
 #define __JSON_OBJECT_H__
 
 #include <ostream>
-#include <unordered_map>
-#include <list>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
+#include <utility>
 
 #include "my_int.h"
 
 namespace JSORON
 {
 
+    /**
+     * @brief non owning view over a contiguous buffer of T
+     */
+    template<typename T>
+    class Span
+    {
+    public:
+        Span() : data(nullptr), size(0) {}
+        Span(T *data, u64 size) : data(data), size(size) {}
+
+        T* begin() const { return data; }
+        T* end() const { return data + size; }
+
+        T& operator[](u64 index) const { return data[index]; }
+
+        T* Data() const { return data; }
+        u64 Size() const { return size; }
+
+    private:
+        T *data;
+        u64 size;
+    };
+
+    /**
+     * @brief FNV-1a hash of a key, used by the JSONObject lookups
+     */
+    constexpr u64 HashKey(const char *str, u64 length)
+    {
+        u64 hash = 14695981039346656037ull;
+        for (u64 index = 0; index < length; ++index)
+        {
+            hash ^= (u8)str[index];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    inline u64 HashKey(std::string_view key)
+    {
+        return HashKey(key.data(), key.size());
+    }
+
+    // NOTE(19.10.26): the structural hashes and the Deduplicator are built from these, 
+    // one copy so they can't drift apart
+    constexpr u64 object_hash_seed = 0x6a09e667f3bcc908ull;
+    constexpr u64 array_hash_seed = 0xbb67ae8584caa73bull;
+
+    /**
+     * @brief mixes value into hash
+     */
+    constexpr u64 CombineHash(u64 hash, u64 value)
+    {
+        return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+    }
+
+    /**
+     * @brief a key with its precomputed hash. build it once outside of a hot loop and 
+     *        reuse it for every lookup of the same key.
+     * NOTE(19.10.26): does not own the characters it points to, they must outlive the Key.
+     */
+    class Key
+    {
+    public:
+        constexpr Key(const char *str, u64 length) : str(str), length(length), hash(HashKey(str, length)) {}
+        explicit Key(std::string_view key) : Key(key.data(), key.size()) {}
+
+        /**
+         * @brief a key whose hash was computed before, e.g. kept next to an owned string
+         */
+        constexpr Key(std::string_view key, u64 hash) : str(key.data()), length(key.size()), hash(hash) {}
+
+        constexpr std::string_view View() const { return std::string_view(str, length); }
+        constexpr u64 Hash() const { return hash; }
+
+    private:
+        const char *str;
+        u64 length;
+        u64 hash;
+    };
+
+    /**
+     * @brief compile time key, e.g. static constexpr Key x0_key = "x0"_key;
+     */
+    constexpr Key operator""_key(const char *str, std::size_t length)
+    {
+        return Key(str, length);
+    }
+
     class JSONObject 
     {
-#ifndef NDEBUG
     public: 
-#endif /* NDEBUG */
         enum class ValueType
         {
             BAD_TYPE,
@@ -44,13 +135,77 @@ namespace JSORON
         class JSONArray
         {
         public:
-            JSONArray() : array() {}
+            /**
+             * NOTE(19.10.26): arrays holding only ints or only doubles are kept packed in a 
+             * s32[]/f64[] buffer. the first element of a different type converts the array
+             * to the GENERIC storage.
+             *
+             * TABLE is opt in, through JSONArray(Storage::TABLE) or ToTable. it holds an 
+             * array of objects with the same keys in the same order as one column per key,
+             * each column an array of its own (packed when the values allow it). rows have
+             * no body and no key strings of their own, a column is one contiguous buffer.
+             * an element that doesn't fit the columns converts the array to GENERIC.
+             */
+            enum class Storage
+            {
+                GENERIC,
+                INTS,
+                DOUBLES,
+                TABLE
+            };
+
+            /**
+             * @brief one key of a TABLE array and its value in every row
+             */
+            struct TableColumn;
+
+            /**
+             * @brief read only view of a row of a TABLE array, the values are copied out 
+             *        of the columns. a missing key gives a BAD_TYPE value.
+             * NOTE(19.10.26): the view points into the array's body, it is invalidated by 
+             * a mutation of the array like a reference from At is.
+             */
+            class RowView
+            {
+            public:
+                RowView(const std::vector<TableColumn> *columns, u64 row) : columns(columns), row(row) {}
+
+                JSONValue operator[](std::string_view key) const;
+                JSONValue operator[](const char *key) const { return (*this)[std::string_view(key)]; }
+                JSONValue operator[](const Key& key) const;
+
+                u64 Size() const;
+                u64 Row() const { return row; }
+
+                /**
+                 * @brief copies the row into a regular object
+                 */
+                JSONObject Materialize() const;
+
+            private:
+                const std::vector<TableColumn> *columns;
+                u64 row;
+            };
+
+            /**
+             * NOTE(19.10.26): the elements live in a reference counted body that is shared 
+             * between copies of the array. copying is O(1), the body is copied on the first 
+             * mutation through a non const member of a shared array.
+             */
+            JSONArray() : body(nullptr) {}
+            explicit JSONArray(Storage storage);
             JSONArray(const JSONArray& other);
+            JSONArray(JSONArray&& other) noexcept;
             JSONArray& operator=(const JSONArray& other);
+            JSONArray& operator=(JSONArray&& other) noexcept;
 
             ~JSONArray();
 
-            typedef std::vector<JSONValue*> ValueArray;
+            /**
+             * NOTE(19.10.26): elements are stored by value in one contiguous buffer,
+             * iterating the array is a linear scan with no per element indirection.
+             */
+            typedef std::vector<JSONValue> ValueArray;
 
             class Iterator {
             public:
@@ -62,8 +217,7 @@ namespace JSORON
                 using reference = JSONValue&;
 
                 // Constructor
-                Iterator(ValueArray::iterator iter) : is_const(0), m_iter(iter) {}
-                Iterator(ValueArray::const_iterator iter) : is_const(1), m_const_iter(iter) {}
+                Iterator(JSONValue *ptr) : m_ptr(ptr) {}
 
                 // Dereference operator
                 reference operator*() const;
@@ -79,34 +233,278 @@ namespace JSORON
                 bool operator!=(const Iterator& other) const;
 
             private:
-                b8 is_const;
-                union
-                {
-                    ValueArray::iterator m_iter;  // Internal pointer for traversal
-                    ValueArray::const_iterator m_const_iter;  // Internal pointer for traversal
-                };
-                
+                JSONValue *m_ptr;  // Internal pointer for traversal
+            };
+
+            class ConstIterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = JSONValue;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const JSONValue*;
+                using reference = const JSONValue&;
+
+                ConstIterator(const JSONValue *ptr) : m_ptr(ptr) {}
+
+                reference operator*() const;
+                ConstIterator& operator++();
+                ConstIterator operator++(int);
+
+                bool operator==(const ConstIterator& other) const;
+                bool operator!=(const ConstIterator& other) const;
+
+            private:
+                const JSONValue *m_ptr;
             };
 
             u64 Size() const;
+            Storage GetStorage() const;
+
+            /**
+             * @brief packed view of an array holding only ints
+             * @return the elements of the array, or an empty span if the array 
+             *         is not of Storage::INTS
+             */
+            Span<const s32> Ints() const;
+            Span<s32> Ints();
+
+            /**
+             * @brief packed view of an array holding only doubles
+             * @return the elements of the array, or an empty span if the array 
+             *         is not of Storage::DOUBLES
+             */
+            Span<const f64> Doubles() const;
+            Span<f64> Doubles();
+
+            /**
+             * @brief the columns of a TABLE array in key order, empty for other storages
+             */
+            Span<const TableColumn> Columns() const;
+
+            /**
+             * @return the values of key in every row, nullptr if the array is not a TABLE 
+             *         or has no such column
+             */
+            const JSONArray* Column(std::string_view key) const;
+            const JSONArray* Column(const Key& key) const;
+
+            /**
+             * @brief row view of a TABLE array, does not unpack the table
+             */
+            RowView Row(u64 index) const;
+
+            /**
+             * @brief copies the value of key in every element into out, in one pass. 
+             *        the key is hashed once and the slot it was found in is tried first 
+             *        on the next element, so a run of objects with the same layout costs 
+             *        one compare per element. a TABLE array copies the column.
+             *        T is s32 or f64, an f64 column takes int values too.
+             * usage:   std::vector<f64> xs(pairs.Size());
+             *          pairs.ExtractColumn(x0_key, Span<f64>(xs.data(), xs.size()));
+             * @param out has room for Size() values
+             * @return 1 if every element had a value of type T at key, 0 otherwise. the 
+             *         elements that had not are written as 0
+             */
+            template<typename T>
+            b8 ExtractColumn(const Key& key, Span<T> out) const;
+
+            /**
+             * @brief ExtractColumn for several keys in the same pass over the elements, 
+             *        the values of keys[i] go to outs[i]
+             */
+            template<typename T>
+            b8 ExtractColumns(Span<const Key> keys, Span<const Span<T>> outs) const;
+
+            /**
+             * @brief converts an array whose elements are all objects with the same keys 
+             *        in the same order to Storage::TABLE
+             * @return 1 if the array is a TABLE now, 0 if its elements don't fit and the 
+             *         array is left unchanged
+             */
+            b8 ToTable();
+
+            /**
+             * @brief the cost of an index, bytes is the memory of its hash table
+             */
+            struct IndexStats
+            {
+                u64 entries;
+                u64 bytes;
+                f64 build_seconds;
+            };
+
+            /**
+             * NOTE(19.10.26): a hash index from the value of key in every element to the
+             * position of the element, for repeated point lookups through Find. it lives in
+             * the body, PushBack, Insert and Erase keep it up to date. the non const At and
+             * iterators hand out references it can't follow, they mark it stale and the next
+             * Find rebuilds it. a change made through a reference from the const At or the
+             * const iterators is not seen. elements that are not objects or have no value at
+             * key are not indexed, a TABLE array is indexed through its column.
+             * @return the cost of the index, an existing index on key is rebuilt
+             */
+            IndexStats BuildIndex(std::string_view key);
+
+            /**
+             * @return 1 if there was an index on key
+             */
+            b8 DropIndex(std::string_view key);
+
+            /**
+             * @return the cost of the index on key, all 0 if there is none
+             */
+            IndexStats GetIndexStats(std::string_view key) const;
+
+            /**
+             * @return position of the first element whose value at key equals value, -1 if
+             *         there is none. O(1) with an index on key, a linear scan without one
+             * NOTE(19.10.26): rebuilding a stale index is done under a lock, readers of a
+             * shared array may call Find at the same time.
+             */
+            s64 Find(const Key& key, const JSONValue& value) const;
+
+            /**
+             * @brief reserves room for capacity elements so the following PushBacks 
+             *        will not reallocate the array
+             */
+            void Reserve(u64 capacity);
+
+            /**
+             * @brief structural hash of the elements, see JSONObject::Hash
+             */
+            u64 Hash() const;
             
             template<typename T>
             void PushBack(const T& value);
 
+            void PushBack(s32 value);
+            void PushBack(f64 value);
+
+            /**
+             * @brief moves *value into the array and deletes value
+             */
             void PushBack(JSONValue *value);
+            void PushBack(JSONValue&& value);
+
+            /**
+             * @brief inserts value before the element at index, index == Size() appends.
+             *        a packed array stays packed if value has its element type
+             */
+            void Insert(u64 index, JSONValue&& value);
             
+            /**
+             * @brief removes the element at index from the array. a packed or TABLE 
+             *        array keeps its storage
+             * @return the removed element
+             */
             JSONValue Erase(u64 index);
-            JSONValue& At(u64 index) const;
 
-            Iterator begin() const;
-            Iterator end() const;
+            /**
+             * @brief removes every element predicate(const JSONValue&) is true for, in one 
+             *        pass that moves each kept element once, so pruning a large array is 
+             *        O(n) and not O(n) per removed element. a packed array stays packed, 
+             *        its elements are passed as values of their type. a TABLE array is 
+             *        converted to Storage::GENERIC first
+             * usage:   pairs.RemoveIf([](const JSONValue& pair) { return pair[x0_key] < 0.0; });
+             * @return number of removed elements
+             */
+            template<typename Predicate>
+            u64 RemoveIf(Predicate&& predicate);
+
+            /**
+             * @brief removes the elements at indices in one pass. packed and TABLE arrays 
+             *        stay as they are
+             * @param indices ascending and unique is fastest, other input is sorted into a 
+             *        copy. duplicates count once and indices >= Size() are ignored
+             * @return number of removed elements
+             */
+            u64 EraseIndices(Span<const u64> indices);
+
+            /**
+             * NOTE(19.10.26): At and the iterators hand out JSONValue references, 
+             * so they convert a packed or TABLE array to Storage::GENERIC first. the const
+             * overloads leave the storage alone, a body may be shared with other arrays and 
+             * threads. they read from a GENERIC copy of the elements that is made once per 
+             * body and dropped on its next mutation, like a reference from At.
+             */
+            JSONValue& At(u64 index);
+            const JSONValue& At(u64 index) const;
+
+            /**
+             * @brief copy of the element at index, does not unpack a packed array. a row of
+             *        a TABLE array is copied into a new object, Row is the cheaper view
+             */
+            JSONValue ValueAt(u64 index) const;
+
+            ConstIterator begin() const;
+            ConstIterator end() const;
             Iterator begin();
             Iterator end();
 
             friend bool operator==(const JSONArray& lhs, const JSONArray& rhs);
             friend bool operator!=(const JSONArray& lhs, const JSONArray& rhs);
+            friend class Deduplicator;
+            friend class Reclaimer;
+#ifdef NDEBUG
         private:
-            ValueArray array;
+#endif /* NDEBUG */
+            struct Indexes;
+
+            class Body
+            {
+            public:
+                std::atomic<u32> ref_count;
+                mutable std::atomic<u64> structural_hash;   // 0 until computed
+                std::unique_ptr<Indexes> indexes;           // nullptr until BuildIndex
+                mutable std::atomic<ValueArray*> unpacked;  // packed or TABLE elements for the const At
+                Storage storage;
+                union
+                {
+                    ValueArray array;
+                    std::vector<s32> int_arr;
+                    std::vector<f64> double_arr;
+                    std::vector<TableColumn> columns;    // a table without columns has no rows yet
+                };
+
+                explicit Body(Storage storage);
+                Body(const Body& other);
+                ~Body();
+
+                u64 Size() const;
+                void Append(JSONValue&& value);
+                void ToGeneric();
+
+                /**
+                 * @return 1 if value is an object with the keys of the columns in order
+                 */
+                b8 FitsTable(const JSONValue& value) const;
+            };
+
+            Body *body;
+
+            /**
+             * @brief makes body unique to this array, allocating it if needed
+             */
+            Body& Mutable();
+            void Release();
+
+            /**
+             * @brief the elements as JSONValues without converting the storage
+             */
+            const ValueArray& Elements() const;
+
+            /**
+             * @brief moves the elements removes(index, element) is false for to the front 
+             *        of values, in order, and destroys the rest
+             * @return number of removed elements
+             */
+            template<typename T, typename Removes>
+            static u64 Compact(std::vector<T>& values, Removes&& removes);
+
+            /**
+             * @brief the next Find rebuilds the indexes of body, its elements moved
+             */
+            static void MarkIndexesStale(Body& body);
         };
         
         class JSONValue 
@@ -126,7 +524,9 @@ namespace JSORON
     
             JSONValue() : type(ValueType::NULL_TYPE) {}
             JSONValue(const JSONValue& value);
+            JSONValue(JSONValue&& value) noexcept;
             JSONValue& operator=(const JSONValue& other);
+            JSONValue& operator=(JSONValue&& other) noexcept;
             
             template<typename T>
             JSONValue& operator=(const T& src);
@@ -139,10 +539,13 @@ namespace JSORON
             JSONValue(const s32 value) : type(ValueType::INT), int_val(value) {}
             JSONValue(const f64 value) : type(ValueType::DOUBLE), double_val(value) {}
             JSONValue(const std::string& value) : type(ValueType::STR), str_val(value) {}
+            JSONValue(std::string&& value) : type(ValueType::STR), str_val(std::move(value)) {}
             JSONValue(const JSONObject* value);
             JSONValue(const JSONObject& value);
+            JSONValue(JSONObject&& value);
     
             JSONValue(const JSONArray& arr) : type(ValueType::ARR), json_arr(arr) {}
+            JSONValue(JSONArray&& arr) : type(ValueType::ARR), json_arr(std::move(arr)) {}
             
             /**
              * @brief overloading cast to int.
@@ -179,29 +582,37 @@ namespace JSORON
             /**
              * @brief for accessing keys from a nested json
              * @return JSONValue with the nested JSONObject
+             * NOTE(19.10.26): the const char* overloads are exact matches for string literals, 
+             * without them value["key"] is ambiguous with the builtin subscript on int&.
              */
-            JSONValue& operator[](std::string key);
-            
-            /**
-             * @brief for accessing keys from a nested json
-             * @return JSONValue with the nested JSONObject
-             */
+            JSONValue& operator[](std::string_view key);
             JSONValue& operator[](const char* key);
+            JSONValue& operator[](const Key& key);
             
             /**
              * @brief for accessing keys from a nested json
              * @return JSONValue with the nested JSONObject
              */
-            const JSONValue& operator[](std::string key) const;
-            
-            /**
-             * @brief for accessing keys from a nested json
-             * @return JSONValue with the nested JSONObject
-             */
+            const JSONValue& operator[](std::string_view key) const;
             const JSONValue& operator[](const char* key) const;
+            const JSONValue& operator[](const Key& key) const;
 
-            void PrintValueByType(u8 indent, std::ostream& out) const;
             void AssignValueByType(const JSONValue& src);
+
+            /**
+             * @brief calls visitor with the value as its own type, s32, f64, 
+             *        const std::string&, const JSONObject&, const JSONArray&, or nullptr 
+             *        for null and missing values.
+             * usage:   value.Visit([](const auto& typed) { ... });
+             * @return what visitor returns, every overload has to return the same type
+             */
+            template<typename Visitor>
+            decltype(auto) Visit(Visitor&& visitor) const;
+
+            /**
+             * @brief structural hash of the value, see JSONObject::Hash
+             */
+            u64 Hash() const;
     
             friend bool operator==(const JSONObject& lhs, const JSONObject& rhs);
             friend bool operator==(const JSONValue& lhs, const JSONValue& rhs);
@@ -211,15 +622,30 @@ namespace JSORON
         };
     
     public:
-        JSONObject() : json(), insertion_order() {}
+        JSONObject() : body(nullptr) {}
         JSONObject(const JSONObject& other);
+        JSONObject(JSONObject&& other) noexcept;
         JSONObject& operator=(const JSONObject& obj);
+        JSONObject& operator=(JSONObject&& obj) noexcept;
         ~JSONObject();
     
         template<typename T>
-        void Put(const std::string key, const T& value);
+        void Put(std::string key, const T& value);
         
-        void Put(const std::string key, JSONValue *value);
+        void Put(std::string&& key, JSONValue&& value);
+
+        /**
+         * @brief moves *value into this json and deletes value
+         */
+        void Put(const std::string& key, JSONValue *value);
+
+        /**
+         * @brief constructs a value from args in place, if key is not in this json
+         * @param key the key for the new value
+         * @return a reference to the value associated with key
+         */
+        template<typename... Args>
+        JSONValue& Emplace(std::string key, Args&&... args);
 
         /**
          * @brief adds a new json object to this json
@@ -229,22 +655,49 @@ namespace JSORON
         JSONObject& AddObj(const std::string& key);
         
         /**
-         * @brief adds a new array of type T to this json
+         * @brief adds a new array of type T to this json, s32 and f64 arrays start 
+         *        with packed storage
          * @param key the key for the new array
-         * @return a reference to the new array that was inserted
+         * @return a reference to the array associated with key
          */
         template<typename T>
-        std::vector<T>& AddArr(const std::string& key);
+        JSONArray& AddArr(const std::string& key);
     
-        void Remove(std::string key);
+        /**
+         * @brief removes key and its value from this json in O(1) amortized, the other 
+         *        members keep their order
+         * @return 1 if key was in this json, 0 otherwise
+         * NOTE(19.10.26): invalidates references into this json like an insertion does.
+         */
+        b8 Remove(std::string_view key);
+
+        /**
+         * @return number of members
+         */
+        u64 Size() const;
+
+        /**
+         * @brief hash of the members and their values, equal objects hash equal. the hash 
+         *        is computed on first use and cached in the body until the next mutation, 
+         *        so operator== rejects most unequal documents without walking them.
+         *        comparing the hash of a document with an old one is a cheap change check.
+         * NOTE(19.10.26): a mutation invalidates the hashes on the path it was reached
+         * through. a reference kept from before the hash was taken must not be written
+         * through afterwards, the same rule as for keeping one across a copy.
+         */
+        u64 Hash() const;
        
         /**
          * @brief access values in json object
          * @param key - the key associated with the value to be pulled from the json object
          * @return if key exists in json object, returns a reference the value associated with 
          *         key else return a reference to a JSONValue of type ValueType::NULL_TYPE
+         * NOTE(19.10.26): copies a body shared with other objects, use the const overload 
+         * for read only access to snapshots. the reference is invalidated by the next 
+         * insertion into or removal from this json.
          */
-        JSONValue& operator[](std::string key);
+        JSONValue& operator[](std::string_view key);
+        JSONValue& operator[](const Key& key);
 
         /**
          * @brief access values in json object
@@ -252,9 +705,30 @@ namespace JSORON
          * @return if key exists in json object, returns a reference the value associated with 
          *         key else return a reference to a JSONValue of type ValueType::NULL_TYPE
          */
-        const JSONValue& operator[](std::string key) const;
+        const JSONValue& operator[](std::string_view key) const;
+        const JSONValue& operator[](const Key& key) const;
+
+        /**
+         * @brief access values in json object with a key known at compile time. the hash 
+         *        and length of K are constants and the search of a small object is inlined, 
+         *        so the lookup is a few compares.
+         * usage:   static constexpr Key x0_key = "x0"_key;
+         *          f64 x0 = pair.Get<x0_key>();
+         * @return same as operator[]
+         */
+        template<const Key& K>
+        JSONValue& Get();
+
+        template<const Key& K>
+        const JSONValue& Get() const;
         
         friend class JSONParser;
+        friend class JSONSerializer;
+        friend class CBOREncoder;
+        friend class SnapshotWriter;
+        friend class Deduplicator;
+        friend class JSONPatch;
+        friend class Reclaimer;
 
         friend bool operator==(const JSONObject& lhs, const JSONObject& rhs);
         friend bool operator!=(const JSONObject& lhs, const JSONObject& rhs);
@@ -264,59 +738,415 @@ namespace JSORON
 #ifdef NDEBUG 
     private:
 #endif /* NDEBUG */
-        typedef std::unordered_map<std::string, JSONValue*>::iterator JSONIter;
+        class Member
+        {
+        public:
+            std::string key;
+            u64 hash;
+            JSONValue value;
+            b8 removed;     // a tombstone, see Body
+
+            template<typename... Args>
+            Member(std::string&& key, u64 hash, Args&&... args) : key(std::move(key)), hash(hash), 
+                                                                  value(std::forward<Args>(args)...), removed(0) {}
+
+            /**
+             * @return 1 for the tombstone of a removed member
+             * NOTE(19.10.26): not the type of the value, a live member may hold the BAD_TYPE 
+             * value a missed lookup returns
+             */
+            b8 IsRemoved() const { return removed; }
+        };
+
+        /**
+         * NOTE(19.10.26): the members live in a reference counted body that is shared 
+         * between copies of the object, so copying a document is O(1). a mutation copies
+         * the bodies on the path from the root to the mutated value, everything else 
+         * stays shared between the versions.
+         *
+         * members are kept in insertion order together with the hash of their key. small 
+         * objects are searched linearly, bigger ones through an open addressing index of 
+         * member slots (slot + 1, 0 marks an empty entry).
+         *
+         * Remove leaves a tombstone in the slot, a member marked removed with the key and 
+         * value freed and the hash kept so the index probes past it, which is O(1) and keeps the order. 
+         * once tombstones outnumber the live members the body is compacted and reindexed,
+         * so churn can't grow a body past twice its live size. every walk over members 
+         * skips tombstones.
+         */
+        class Body
+        {
+        public:
+            static const u64 linear_lookup_max = 8;
+
+            std::atomic<u32> ref_count;
+            mutable std::atomic<u64> structural_hash;   // 0 until computed
+            std::vector<Member> members;
+            std::vector<u32> index;
+            u64 num_removed;
+
+            Body() : ref_count(1), structural_hash(0), members(), index(), num_removed(0) {}
+            Body(const Body& other) : ref_count(1), structural_hash(0), members(other.members), 
+                                      index(other.index), num_removed(other.num_removed) {}
+
+            /**
+             * @return number of live members
+             */
+            u64 Size() const { return members.size() - num_removed; }
+
+            /**
+             * @return the slot of the member with key, or -1 if key is not in the body
+             */
+            s64 Find(std::string_view key, u64 hash) const;
+
+            /**
+             * @brief adds the last member to the index, growing the index if needed
+             */
+            void IndexLast();
+            void Reindex();
+
+            /**
+             * @brief drops the tombstones, the live members keep their order but move slots
+             */
+            void Compact();
+        };
     
         static const JSONValue bad_value;
-        std::unordered_map<std::string, JSONValue*> json;
-        std::list<std::string> insertion_order;
+        static const Body empty_body;
+        Body *body;
     
-        void RecPrint(u8 indent, std::ostream& out) const;
+        /**
+         * @brief makes body unique to this object, allocating it if needed
+         */
+        Body& Mutable();
+        const Body& Read() const { return body ? *body : empty_body; }
+        void Release();
+
+        template<const Key& K>
+        s64 FindStatic() const;
+
+        JSONValue& Lookup(std::string_view key, u64 hash);
+        const JSONValue& Lookup(std::string_view key, u64 hash) const;
+
+    public:
+        /**
+         * @brief a member as seen through the iterators
+         */
+        template<typename Value>
+        struct Entry
+        {
+            std::string_view key;
+            Value& value;
+        };
+
+        /**
+         * NOTE(19.10.26): walks the member slots in insertion order and skips tombstones. 
+         * every step reaches the value directly, no key is hashed or compared, so walking 
+         * an object is a linear scan of its slots.
+         */
+        template<typename Value>
+        class MemberIterator
+        {
+        public:
+            using MemberPtr = typename std::conditional<std::is_const<Value>::value, 
+                                                        const Member*, Member*>::type;
+
+            // Iterator traits
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry<Value>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Entry<Value>;
+
+            MemberIterator(MemberPtr at, MemberPtr stop) : at(at), stop(stop) { SkipRemoved(); }
+
+            reference operator*() const { return Entry<Value>{at->key, at->value}; }
+
+            MemberIterator& operator++()
+            {
+                ++at;
+                SkipRemoved();
+                return *this;
+            }
+
+            MemberIterator operator++(int)
+            {
+                MemberIterator old = *this;
+                ++(*this);
+                return old;
+            }
+
+            bool operator==(const MemberIterator& other) const { return at == other.at; }
+            bool operator!=(const MemberIterator& other) const { return at != other.at; }
+
+        private:
+            MemberPtr at;
+            MemberPtr stop;
+
+            void SkipRemoved()
+            {
+                while (at != stop && at->IsRemoved())
+                {
+                    ++at;
+                }
+            }
+        };
+
+        typedef MemberIterator<JSONValue> Iterator;
+        typedef MemberIterator<const JSONValue> ConstIterator;
+
+        /**
+         * @brief members in insertion order, for (auto [key, value] : obj)
+         * NOTE(19.10.26): the non const overloads copy a body shared with other objects, 
+         * like operator[]. an insertion or a removal invalidates the iterators.
+         */
+        ConstIterator begin() const;
+        ConstIterator end() const;
+        Iterator begin();
+        Iterator end();
+
+        /**
+         * @brief calls visitor(key, typed value) for every member in insertion order, 
+         *        the value is passed as in JSONValue::Visit
+         */
+        template<typename Visitor>
+        void ForEachMember(Visitor&& visitor) const;
     };
     
     typedef JSONObject::JSONArray JSONArray;    
     typedef JSONObject::JSONValue JSONValue;    
 
+    struct JSONObject::JSONArray::TableColumn
+    {
+        std::string key;
+        u64 hash;
+        JSONArray values;
+    };
+
     template<typename T>
     void JSONObject::JSONArray::PushBack(const T& value)
     {
-        JSONValue *new_val = new JSONValue(value);
-        array.push_back(new_val);
+        Mutable().Append(JSONValue(value));
     }
 
     template<typename T>
     JSONObject::JSONValue& JSONObject::JSONValue::operator=(const T& src)
     {
-        this->~JSONValue();
-    
-        JSONValue *new_value = new JSONValue(src);
-        AssignValueByType(*new_value);
-        delete new_value;
-    
-        return *this;
+        return *this = JSONValue(src);
+    }
+
+    template<typename Visitor>
+    decltype(auto) JSONObject::JSONValue::Visit(Visitor&& visitor) const
+    {
+        switch (type)
+        {
+            case ValueType::INT:
+            {
+                return visitor(int_val);
+            }
+
+            case ValueType::DOUBLE:
+            {
+                return visitor(double_val);
+            }
+
+            case ValueType::KEY:
+            case ValueType::STR:
+            {
+                return visitor(static_cast<const std::string&>(str_val));
+            }
+
+            case ValueType::JSON_OBJECT:
+            {
+                return visitor(static_cast<const JSONObject&>(*json_val));
+            }
+
+            case ValueType::ARR:
+            {
+                return visitor(static_cast<const JSONArray&>(json_arr));
+            }
+
+            case ValueType::BAD_TYPE:
+            case ValueType::NULL_TYPE:
+            case ValueType::NUM_JSON_TYPES:
+            {
+            } break;
+        }
+
+        return visitor(nullptr);
+    }
+
+    template<typename T, typename Removes>
+    u64 JSONObject::JSONArray::Compact(std::vector<T>& values, Removes&& removes)
+    {
+        u64 kept = 0;
+        for (u64 index = 0; index < values.size(); ++index)
+        {
+            if (removes(index, values[index]))
+            {
+                continue;
+            }
+
+            if (kept != index)
+            {
+                values[kept] = std::move(values[index]);
+            }
+            ++kept;
+        }
+
+        u64 num_removed = values.size() - kept;
+        values.erase(std::next(values.begin(), kept), values.end());
+        return num_removed;
+    }
+
+    template<typename Predicate>
+    u64 JSONObject::JSONArray::RemoveIf(Predicate&& predicate)
+    {
+        if (Size() == 0)
+        {
+            return 0;
+        }
+
+        Body& mutable_body = Mutable();
+        u64 num_removed = 0;
+        switch (mutable_body.storage)
+        {
+            case Storage::INTS:
+            {
+                JSONValue element(0);
+                num_removed = Compact(mutable_body.int_arr, [&predicate, &element](u64, s32 num)
+                {
+                    element.int_val = num;
+                    return (b8)predicate(static_cast<const JSONValue&>(element));
+                });
+            } break;
+
+            case Storage::DOUBLES:
+            {
+                JSONValue element(0.0);
+                num_removed = Compact(mutable_body.double_arr, [&predicate, &element](u64, f64 num)
+                {
+                    element.double_val = num;
+                    return (b8)predicate(static_cast<const JSONValue&>(element));
+                });
+            } break;
+
+            case Storage::TABLE:
+            case Storage::GENERIC:
+            {
+                mutable_body.ToGeneric();
+                num_removed = Compact(mutable_body.array, [&predicate](u64, const JSONValue& element)
+                {
+                    return (b8)predicate(element);
+                });
+            } break;
+        }
+
+        if (num_removed)
+        {
+            MarkIndexesStale(mutable_body);
+        }
+
+        return num_removed;
+    }
+
+    template<typename Visitor>
+    void JSONObject::ForEachMember(Visitor&& visitor) const
+    {
+        for (const Entry<const JSONValue>& entry : *this)
+        {
+            entry.value.Visit([&visitor, &entry](const auto& typed) { visitor(entry.key, typed); });
+        }
     }
     
     template<typename T>
-    void JSONObject::Put(const std::string key, const T& value)
+    void JSONObject::Put(std::string key, const T& value)
+    {
+        Emplace(std::move(key), value);
+    }
+
+    template<typename... Args>
+    JSONObject::JSONValue& JSONObject::Emplace(std::string key, Args&&... args)
     {
-        JSONValue* new_value = new JSONValue(value);
-        auto res = json.insert({key, new_value});
-        if (res.second)
+        Body& mutable_body = Mutable();
+
+        u64 hash = HashKey(key);
+        s64 slot = mutable_body.Find(key, hash);
+        if (slot >= 0)
         {
-            insertion_order.push_back(key);
+            return mutable_body.members[slot].value;
         }
+
+        mutable_body.members.emplace_back(std::move(key), hash, std::forward<Args>(args)...);
+        mutable_body.IndexLast();
+        return mutable_body.members.back().value;
     }
     
-    template<typename T>
-    std::vector<T>& JSONObject::AddArr(const std::string& key)
+    template<const Key& K>
+    s64 JSONObject::FindStatic() const
+    {
+        const Body& read_body = Read();
+        if (!read_body.index.empty())
+        {
+            return read_body.Find(K.View(), K.Hash());
+        }
+
+        for (u64 slot = 0; slot < read_body.members.size(); ++slot)
+        {
+            const Member& member = read_body.members[slot];
+            if (member.hash == K.Hash() && std::string_view(member.key) == K.View() && !member.IsRemoved())
+            {
+                return slot;
+            }
+        }
+
+        return -1;
+    }
+
+    template<const Key& K>
+    JSONObject::JSONValue& JSONObject::Get()
     {
-        std::vector<T> new_arr;
-        JSONValue* new_value = new JSONValue(new_arr);
-        auto res = json.insert({key, new_value});
-        if (res.second)
+        s64 slot = FindStatic<K>();
+        if (slot < 0)
         {
-            insertion_order.push_back(key);
+            return const_cast<JSONValue&>(bad_value);
         }
-        return res.first->second;
+        return Mutable().members[slot].value;
+    }
+
+    template<const Key& K>
+    const JSONObject::JSONValue& JSONObject::Get() const
+    {
+        s64 slot = FindStatic<K>();
+        if (slot < 0)
+        {
+            return bad_value;
+        }
+        return Read().members[slot].value;
+    }
+
+    template<typename T>
+    struct ArrayStorageOf
+    {
+        static const JSONArray::Storage value = JSONArray::Storage::GENERIC;
+    };
+
+    template<>
+    struct ArrayStorageOf<s32>
+    {
+        static const JSONArray::Storage value = JSONArray::Storage::INTS;
+    };
+
+    template<>
+    struct ArrayStorageOf<f64>
+    {
+        static const JSONArray::Storage value = JSONArray::Storage::DOUBLES;
+    };
+    
+    template<typename T>
+    JSONArray& JSONObject::AddArr(const std::string& key)
+    {
+        return Emplace(key, JSONArray(ArrayStorageOf<T>::value));
     }
     
 }
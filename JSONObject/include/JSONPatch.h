@@ -0,0 +1,89 @@
+/* ------------------------------------------*/
+/* Filename: JSONPatch.h                     */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __JSONPATCH_H__
+#define __JSONPATCH_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): JSON Patch (RFC 6902) between two versions of a document. a patch
+     * is a JSONArray of operation objects, {"op": ..., "path": ..., "value": ...}, so it
+     * serializes and parses like any other document. paths are JSON Pointers (RFC 6901).
+     *
+     * Diff skips every subtree the two versions still share (same body) or that hashes
+     * differently only where it has to descend. versions made from one another by
+     * copy and mutate share everything off the changed paths, so the diff costs the
+     * members of the containers on those paths, not the size of the document.
+     *
+     * usage:   JSONArray patch = JSONPatch::Diff(old_config, new_config);
+     *          JSONPatch::Apply(replica, patch);
+     */
+    class JSONPatch
+    {
+    public:
+        /**
+         * @return the operations that turn from into to, empty if they are equal.
+         *         emits add, remove and replace. arrays are diffed after trimming their
+         *         common prefix and suffix. objects are equal only with their members in
+         *         the same order, so applying the patch rebuilds the order of to: a member
+         *         that moved, or comes after one that was inserted, is removed and added
+         *         again with its value from to
+         */
+        static JSONArray Diff(const JSONObject& from, const JSONObject& to);
+
+        /**
+         * @brief applies the operations of patch to doc in order, add, remove, replace,
+         *        move, copy and test are supported
+         * @return 1 if every operation applied, 0 otherwise and doc is left unchanged
+         */
+        static b8 Apply(JSONObject& doc, const JSONArray& patch);
+
+        /**
+         * @brief appends "/" and token to pointer, escaping ~ and / in the token
+         */
+        static void AppendToken(std::string& pointer, std::string_view token);
+
+        /**
+         * @brief splits pointer into its unescaped reference tokens, "" is the root
+         * @return 0 if pointer is not a valid JSON Pointer
+         */
+        static b8 SplitPointer(std::string_view pointer, std::vector<std::string>& tokens);
+
+    private:
+        using Tokens = std::vector<std::string>;
+
+        static void DiffValue(const JSONValue& from, const JSONValue& to, std::string& path,
+                              JSONArray& patch);
+        static void DiffObject(const JSONObject& from, const JSONObject& to, std::string& path,
+                               JSONArray& patch);
+        static void DiffArray(const JSONArray& from, const JSONArray& to, std::string& path,
+                              JSONArray& patch);
+        static void PushOp(JSONArray& patch, const char *op, const std::string& path,
+                           const JSONValue *value);
+
+        static b8 ApplyOp(JSONValue& root, const JSONObject& op);
+        static b8 Add(JSONValue& root, const Tokens& tokens, const JSONValue& value);
+        static b8 Remove(JSONValue& root, const Tokens& tokens);
+        static b8 Replace(JSONValue& root, const Tokens& tokens, const JSONValue& value);
+        static b8 Find(const JSONValue& root, const Tokens& tokens, JSONValue& out);
+
+        /**
+         * @return the container at the first count tokens, nullptr if there is none
+         */
+        static JSONValue* Locate(JSONValue& root, const Tokens& tokens, u64 count);
+        static b8 ParseIndex(std::string_view token, u64& index);
+    };
+}
+
+#endif /* __JSONPATCH_H__ */
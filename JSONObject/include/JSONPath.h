@@ -0,0 +1,278 @@
+/* ------------------------------------------*/
+/* Filename: JSONPath.h                      */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __JSONPATH_H__
+#define __JSONPATH_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * @brief a value selected by a JSONPath, a view into the document. packed elements
+     *        and the rows and cells of a TABLE array have no JSONValue of their own, they
+     *        are seen as their array and index.
+     * NOTE(19.10.26): valid until the document is mutated, like a reference from At.
+     */
+    class PathValue
+    {
+    public:
+        enum class Kind
+        {
+            NONE,
+            OBJECT,     // an object that is no JSONValue, the root
+            VALUE,      // a JSONValue in the document
+            ELEMENT,    // an element of a packed array
+            ROW         // a row of a TABLE array
+        };
+
+        PathValue() : kind(Kind::NONE), value(nullptr), obj(nullptr), arr(nullptr), index(0) {}
+        explicit PathValue(const JSONObject& obj) : kind(Kind::OBJECT), value(nullptr), obj(&obj), arr(nullptr), 
+                                                     index(0) {}
+        explicit PathValue(const JSONValue& value);
+
+        /**
+         * @brief the element at index of arr, as the kind its storage allows
+         */
+        static PathValue ElementOf(const JSONObject::JSONArray& arr, u64 index);
+
+        Kind GetKind() const { return kind; }
+        JSONObject::ValueType Type() const;
+
+        /**
+         * @return the value in the document, nullptr for packed elements and rows
+         */
+        const JSONValue* Value() const { return kind == Kind::VALUE ? value : nullptr; }
+
+        /**
+         * @return the array and index of an ELEMENT or a ROW
+         */
+        const JSONObject::JSONArray* Array() const { return arr; }
+        u64 Index() const { return index; }
+
+        /**
+         * @return the number, AsInt truncates a double and AsDouble widens an int. 0 for
+         *         other types
+         */
+        s32 AsInt() const;
+        f64 AsDouble() const;
+        std::string_view AsStr() const;
+
+        /**
+         * @brief copies the selected value out of the document
+         */
+        JSONValue Copy() const;
+
+        /**
+         * @brief the member or column key of an object or a row, NONE if there is none
+         */
+        PathValue Child(const Key& key) const;
+
+        /**
+         * @brief calls visitor(PathValue) for every member value or element, in order
+         */
+        template<typename Visitor>
+        void ForEachChild(Visitor&& visitor) const;
+
+    private:
+        PathValue(Kind kind, const JSONObject::JSONArray& arr, u64 index) : kind(kind), value(nullptr), 
+                                                                             obj(nullptr), arr(&arr), index(index) {}
+
+        Kind kind;
+        const JSONValue *value;
+        const JSONObject *obj;              // OBJECT, and a VALUE holding an object
+        const JSONObject::JSONArray *arr;   // ELEMENT and ROW
+        u64 index;
+    };
+
+    /**
+     * NOTE(19.10.26): a JSONPath expression compiled into a plan of steps. Compile parses
+     * it once and hashes every key, Run walks a document along the plan without parsing
+     * or copying, so one plan serves every document it runs against.
+     *
+     *  $                   the root
+     *  .name ['name']      a member, or the column of the rows of a TABLE array
+     *  .* [*]              every member value or element
+     *  [n] [-n]            an element, negative from the end
+     *  [start:end:step]    a slice, as in Python
+     *  ..name ..* ..[...]  recursive descent
+     *  [?(filter)]         elements (or member values) the filter holds for. a filter is
+     *                      @ paths compared to literals with == != < <= > >=, or on their
+     *                      own for existence, joined by && and ||. true and false are the
+     *                      ints 1 and 0, as the parser reads them
+     *
+     * packed arrays are walked through their spans and TABLE arrays through their
+     * columns, no array is unpacked and no element copied. $.pairs[?(@.x0 > 0)].y0 on a
+     * table reads two columns.
+     *
+     * usage:   JSONPath path;
+     *          path.Compile("$.pairs[?(@.x0 > 0)].y0");
+     *          path.Run(doc, [&](const PathValue& y0) { sum += y0.AsDouble(); });
+     */
+    class JSONPath
+    {
+    public:
+        /**
+         * @return 1 if expression is a valid path, 0 otherwise and the plan is empty
+         */
+        b8 Compile(std::string_view expression);
+
+        b8 Good() const { return compiled; }
+
+        /**
+         * @brief calls visitor(const PathValue&) for every match, in document order
+         */
+        template<typename Visitor>
+        void Run(const JSONObject& doc, Visitor&& visitor) const;
+
+        /**
+         * @brief appends every match to out, clear and reuse out between runs
+         * @return number of matches appended
+         */
+        u64 Select(const JSONObject& doc, std::vector<PathValue>& out) const;
+
+    private:
+        enum class StepType
+        {
+            CHILD,
+            WILDCARD,
+            INDEX,
+            SLICE,
+            FILTER
+        };
+
+        enum class Compare
+        {
+            EXISTS,
+            EQ,
+            NE,
+            LT,
+            LE,
+            GT,
+            GE
+        };
+
+        /**
+         * @brief a key with its hash, or an index
+         */
+        struct Token
+        {
+            std::string name;
+            u64 hash;
+            s64 index;
+            b8 is_index;
+
+            Key GetKey() const { return Key(name, hash); }
+        };
+
+        /**
+         * @brief a relative path with the literal it is compared to
+         */
+        struct Condition
+        {
+            std::vector<Token> path;
+            Compare compare;
+            JSONValue literal;
+        };
+
+        struct Step
+        {
+            StepType type;
+            b8 descendants;         // ..
+            Token token;            // CHILD and INDEX
+            s64 start;
+            s64 end;
+            s64 stride;
+            b8 has_start;
+            b8 has_end;
+            std::vector<std::vector<Condition>> filter;     // or of ands
+
+            Step() : type(StepType::CHILD), descendants(0), token(), start(0), end(0), stride(1), 
+                     has_start(0), has_end(0), filter() {}
+        };
+
+        class Sink
+        {
+        public:
+            virtual void Emit(const PathValue& match) = 0;
+        };
+
+        template<typename Visitor>
+        class VisitorSink : public Sink
+        {
+        public:
+            explicit VisitorSink(Visitor& visitor) : visitor(visitor) {}
+            void Emit(const PathValue& match) override { visitor(match); }
+
+        private:
+            Visitor& visitor;
+        };
+
+        std::vector<Step> steps;
+        b8 compiled = 0;
+
+        void Evaluate(const JSONObject& doc, Sink& sink) const;
+        void Apply(const PathValue& node, u64 step, Sink& sink) const;
+        void ApplyHere(const PathValue& node, u64 step, Sink& sink) const;
+
+        static b8 Holds(const std::vector<std::vector<Condition>>& filter, const PathValue& node);
+        static b8 Holds(const Condition& condition, const PathValue& node);
+
+        template<typename T>
+        static b8 Matches(Compare compare, const T& lhs, const T& rhs);
+
+        static b8 ParseStep(std::string_view& rest, Step& step);
+        static b8 ParseBracket(std::string_view& rest, Step& step);
+        static b8 ParseFilter(std::string_view& rest, Step& step);
+        static b8 ParseCondition(std::string_view& rest, Condition& condition);
+        static b8 ParseName(std::string_view& rest, Token& token);
+        static b8 ParseQuoted(std::string_view& rest, std::string& str);
+        static b8 ParseToken(std::string_view& rest, Token& token);
+        static b8 ParseInt(std::string_view& rest, s64& num);
+        static b8 ParseLiteral(std::string_view& rest, JSONValue& literal);
+        static void SkipSpaces(std::string_view& rest);
+    };
+
+    template<typename Visitor>
+    void PathValue::ForEachChild(Visitor&& visitor) const
+    {
+        if (kind == Kind::ROW)
+        {
+            for (const JSONObject::JSONArray::TableColumn& column : arr->Columns())
+            {
+                visitor(ElementOf(column.values, index));
+            }
+        }
+        else if (obj)
+        {
+            for (const JSONObject::Entry<const JSONValue>& member : *obj)
+            {
+                visitor(PathValue(member.value));
+            }
+        }
+        else if (kind == Kind::VALUE && value->type == JSONObject::ValueType::ARR)
+        {
+            for (u64 element = 0; element < value->json_arr.Size(); ++element)
+            {
+                visitor(ElementOf(value->json_arr, element));
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void JSONPath::Run(const JSONObject& doc, Visitor&& visitor) const
+    {
+        VisitorSink<Visitor> sink(visitor);
+        Evaluate(doc, sink);
+    }
+}
+
+#endif /* __JSONPATH_H__ */
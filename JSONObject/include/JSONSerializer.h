@@ -0,0 +1,94 @@
+/* ------------------------------------------*/
+/* Filename: JSONSerializer.h                */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __JSONSERIALIZER_H__
+#define __JSONSERIALIZER_H__
+
+#include <string_view>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): writes JSON text into a single byte buffer. in buffer mode the
+     * buffer grows geometrically and holds the whole document, in fd mode it has a
+     * fixed capacity and is written to the fd whenever it fills up. nodes never
+     * allocate on their own, keys and strings are copied straight into the buffer
+     * and escaped in runs.
+     */
+    class JSONSerializer
+    {
+    public:
+        enum class Style
+        {
+            COMPACT,
+            PRETTY
+        };
+
+        static const u64 default_capacity = 64 * 1024;
+
+        explicit JSONSerializer(Style style = Style::COMPACT);
+
+        /**
+         * @brief the serializer does not own fd, it is flushed but not closed on destruction
+         */
+        explicit JSONSerializer(s32 fd, Style style = Style::COMPACT,
+                                u64 capacity = default_capacity);
+        ~JSONSerializer();
+
+        JSONSerializer(const JSONSerializer& other) = delete;
+        JSONSerializer& operator=(const JSONSerializer& other) = delete;
+
+        void Write(const JSONObject& obj);
+        void Write(const JSONObject::JSONValue& value);
+
+        /**
+         * @brief writes the buffered bytes to the fd, no-op in buffer mode
+         * @return 1 if every byte written so far reached the fd, 0 otherwise
+         */
+        b8 Flush();
+
+        /**
+         * @return the bytes that were not flushed yet, in buffer mode the whole output
+         */
+        std::string_view View() const { return std::string_view(data, size); }
+        std::string Str() const { return std::string(data, size); }
+        void Clear() { size = 0; }
+
+        b8 Good() const { return !failed; }
+
+        friend class JSONWriter;
+
+    private:
+        Style style;
+        s32 fd;
+        b8 failed;
+
+        char *data;
+        u64 size;
+        u64 capacity;
+
+        void WriteValue(const JSONObject::JSONValue& value, u32 depth);
+        void WriteObject(const JSONObject& obj, u32 depth);
+        void WriteArray(const JSONObject::JSONArray& arr, u32 depth);
+        void WriteString(std::string_view str);
+        void WriteInt(s64 num);
+        void WriteDouble(f64 num);
+        void WriteNewLine(u32 depth);
+
+        /**
+         * @brief makes room for at least n more bytes, flushing or growing the buffer
+         * @return where the next byte goes
+         */
+        char* Reserve(u64 n);
+        void Append(const char *src, u64 n);
+        void Append(char c) { *Reserve(1) = c; ++size; }
+    };
+}
+
+#endif /* __JSONSERIALIZER_H__ */
@@ -0,0 +1,106 @@
+/* ------------------------------------------*/
+/* Filename: JSONWriter.h                    */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __JSONWRITER_H__
+#define __JSONWRITER_H__
+
+#include <string_view>
+
+#include "JSONObject.h"
+#include "JSONSerializer.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): writes a document token by token without building it first.
+     * the output goes through the same buffer as JSONSerializer, so with an fd it
+     * takes a fixed amount of memory no matter how big the document gets.
+     *
+     * usage:   JSONWriter writer(fd);
+     *          writer.BeginObject();
+     *          writer.Key("pairs");
+     *          writer.BeginArray();
+     *          writer.Double(x0);
+     *          writer.EndArray();
+     *          writer.EndObject();
+     *
+     * every call is checked against the open containers. a call that would produce
+     * invalid JSON (a value where a key is expected, a mismatched End, a second root,
+     * nesting deeper than max_depth) writes nothing, returns 0 and fails the writer,
+     * every call after that returns 0 as well.
+     */
+    class JSONWriter
+    {
+    public:
+        typedef JSONSerializer::Style Style;
+
+        static const u32 max_depth = 512;
+
+        explicit JSONWriter(Style style = Style::COMPACT);
+
+        /**
+         * @brief the writer does not own fd, it is flushed but not closed on destruction
+         */
+        explicit JSONWriter(s32 fd, Style style = Style::COMPACT,
+                            u64 capacity = JSONSerializer::default_capacity);
+
+        b8 BeginObject();
+        b8 EndObject();
+        b8 BeginArray();
+        b8 EndArray();
+        b8 Key(std::string_view key);
+
+        b8 Null();
+        b8 Int(s64 num);
+        b8 Double(f64 num);
+        b8 String(std::string_view str);
+
+        /**
+         * @brief writes a whole subtree in the place of a single value
+         */
+        b8 Value(const JSONObject::JSONValue& value);
+        b8 Value(const JSONObject& obj);
+
+        /**
+         * @return 1 if the document is complete: one root value, every container closed
+         */
+        b8 Done() const { return !failed && has_root && depth == 0; }
+        b8 Good() const { return !failed && out.Good(); }
+
+        b8 Flush() { return out.Flush(); }
+
+        /**
+         * @return the bytes that were not flushed yet, in buffer mode the whole output
+         */
+        std::string_view View() const { return out.View(); }
+        std::string Str() const { return out.Str(); }
+
+    private:
+        enum FrameFlags : u8
+        {
+            IN_OBJECT = 1 << 0,
+            HAS_MEMBERS = 1 << 1,
+            AFTER_KEY = 1 << 2
+        };
+
+        JSONSerializer out;
+        b8 failed;
+        b8 has_root;
+        u32 depth;
+        u8 frames[max_depth];
+
+        /**
+         * @brief checks that a value may come next and writes the separator before it
+         */
+        b8 BeginValue();
+        b8 Begin(char open, u8 flags);
+        b8 End(char close, u8 flags);
+        b8 Fail() { failed = 1; return 0; }
+    };
+}
+
+#endif /* __JSONWRITER_H__ */
@@ -0,0 +1,33 @@
+/* ------------------------------------------*/
+/* Filename: NumberFormat.h                  */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __NUMBERFORMAT_H__
+#define __NUMBERFORMAT_H__
+
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): number to text for every output path. each function writes
+     * into out, which must have room for the matching max_*_chars, and returns the
+     * end of what it wrote. nothing is null terminated.
+     */
+    static const u64 max_int_chars = 20;
+    static const u64 max_double_chars = 32;
+
+    char* FormatUInt(char *out, u64 num);
+    char* FormatInt(char *out, s64 num);
+
+    /**
+     * @brief writes the shortest text that parses back to exactly num. integral values
+     *        get a trailing ".0" so they stay doubles when parsed, nan and infinity
+     *        have no JSON literal and are written as null
+     */
+    char* FormatDouble(char *out, f64 num);
+}
+
+#endif /* __NUMBERFORMAT_H__ */
@@ -0,0 +1,104 @@
+/* ------------------------------------------*/
+/* Filename: Reclaimer.h                     */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __RECLAIMER_H__
+#define __RECLAIMER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): frees dropped documents on a background thread. Drop moves the
+     * document into a queue and returns, the reclaimer thread takes the whole queue
+     * at once and lets the documents go there. bodies still shared with a live copy
+     * only lose a reference, so dropping a copy never frees what the caller still uses.
+     *
+     * the queue is bounded and reserved up front, Drop doesn't allocate, so it never
+     * waits on the allocator while the reclaimer is freeing. a Drop that finds the
+     * queue full frees the document on the caller like the destructor would, a burst
+     * of drops can't pile up memory without limit.
+     *
+     * on Linux the reclaimer thread runs at SCHED_IDLE. it frees in the cpu time nobody
+     * else wants and never preempts the threads that drop, under full load the queue
+     * fills up and drops fall back to freeing inline.
+     *
+     * usage:   Reclaimer reclaimer;
+     *          reclaimer.Drop(std::move(big_doc));
+     */
+    class Reclaimer
+    {
+    public:
+        /**
+         * throughput is bytes_reclaimed / reclaim_seconds. bytes are estimated from the
+         * capacities of the bodies that are freed, bodies shared with live copies are
+         * not counted
+         */
+        struct Stats
+        {
+            u64 documents_queued;
+            u64 documents_reclaimed;
+            u64 documents_inline;       // freed on the caller, the queue was full
+            u64 bytes_reclaimed;
+            f64 reclaim_seconds;        // time the reclaimer thread spent freeing
+            u64 peak_pending;           // most documents waiting at once
+            u64 peak_batch_bytes;       // most bytes held by one batch taken off the queue
+        };
+
+        static const u64 default_max_pending = 1024;
+
+        explicit Reclaimer(u64 max_pending = default_max_pending);
+
+        /**
+         * @brief frees whatever is still queued, then stops the thread
+         */
+        ~Reclaimer();
+
+        Reclaimer(const Reclaimer& other) = delete;
+        Reclaimer& operator=(const Reclaimer& other) = delete;
+
+        /**
+         * @brief hands doc over to the reclaimer, doc is left empty
+         */
+        void Drop(JSONObject&& doc);
+        void Drop(JSONObject::JSONArray&& arr);
+
+        /**
+         * @brief blocks until every document dropped so far is freed
+         */
+        void Flush();
+
+        Stats GetStats() const;
+
+    private:
+        u64 max_pending;
+        std::vector<JSONObject> pending_objects;
+        std::vector<JSONObject::JSONArray> pending_arrays;
+        Stats stats;
+        b8 busy;
+        b8 stopping;
+
+        mutable std::mutex mutex;
+        std::condition_variable work;
+        std::condition_variable idle;
+        std::thread worker;
+
+        u64 NumPending() const { return pending_objects.size() + pending_arrays.size(); }
+        void Run();
+
+        static u64 MeasureValue(const JSONObject::JSONValue& value);
+        static u64 MeasureObject(const JSONObject& obj);
+        static u64 MeasureArray(const JSONObject::JSONArray& arr);
+    };
+}
+
+#endif /* __RECLAIMER_H__ */
@@ -0,0 +1,233 @@
+/* ------------------------------------------*/
+/* Filename: Snapshot.h                      */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "JSONObject.h"
+#include "my_int.h"
+
+namespace JSORON
+{
+    /**
+     * NOTE(19.10.26): a snapshot is a parsed document laid out as one relocatable
+     * buffer, every reference inside it is an offset from the start of the buffer.
+     * it is written once and then mapped read only, reading it needs no parsing and
+     * no allocation.
+     *
+     *  SnapshotHeader
+     *  nodes           objects are member tables in insertion order, followed by a
+     *                  hash sorted slot index for bigger objects.
+     *                  generic arrays are SnapshotNode tables, packed arrays are
+     *                  raw s32 / f64 arrays
+     *  string table    every distinct key and string once, back to back
+     *
+     * all offsets are 8 byte aligned and values are in host byte order, Open rejects
+     * a snapshot written with the other byte order.
+     */
+    struct SnapshotHeader
+    {
+        char magic[8];
+        u32 version;
+        u32 byte_order;
+        u64 file_size;
+        u64 string_table;
+        u64 root;
+    };
+
+    struct SnapshotNode
+    {
+        u8 type;        // JSONObject::ValueType
+        u8 storage;     // JSONArray::Storage, for arrays
+        u16 reserved;
+        u32 size;       // string length, member or element count
+        u64 payload;    // s32, f64 bits, or the offset of the string / table
+    };
+
+    struct SnapshotMember
+    {
+        u64 hash;
+        u64 key_offset;
+        u32 key_size;
+        u32 reserved;
+        SnapshotNode value;
+    };
+
+    class SnapshotWriter
+    {
+        friend class FrozenDocument;
+
+    public:
+        void Write(const JSONObject& root);
+
+        const std::vector<u8>& Bytes() const { return bytes; }
+
+        /**
+         * @return 1 if the whole snapshot was written to path
+         */
+        b8 WriteToFile(const std::string& path) const;
+
+    private:
+        std::vector<u8> bytes;
+        std::vector<char> strings;
+        std::unordered_map<std::string_view, u64> string_offsets;
+
+        u64 Allocate(u64 size);
+        u64 InternString(std::string_view str);
+
+        void WriteValue(const JSONObject::JSONValue& value, u64 node_offset);
+        void WriteObject(const JSONObject& obj, u64 node_offset);
+        void WriteArray(const JSONObject::JSONArray& arr, u64 node_offset);
+        void WriteRow(const JSONObject::JSONArray& arr, u64 row, u64 node_offset);
+        void WriteElement(const JSONObject::JSONArray& arr, u64 index, u64 node_offset);
+        void StoreNode(u64 node_offset, const SnapshotNode& node);
+
+        /**
+         * @brief member tables are written in three steps, the table, every member, then
+         *        the object node with the hash sorted slot index of a bigger object
+         */
+        u64 AllocateMembers(u64 num_members);
+        u64 StoreMember(u64 table, u64 slot, u64 hash, std::string_view key);
+        void StoreObject(u64 node_offset, u64 table, const std::vector<u64>& hashes);
+    };
+
+    /**
+     * @brief read only accessor over a node inside a snapshot, mirrors the JSONValue
+     *        lookups. a missing key or index gives a BAD_TYPE value
+     */
+    class SnapshotValue
+    {
+    public:
+        SnapshotValue() : base(nullptr), node(nullptr) {}
+        SnapshotValue(const u8 *base, const SnapshotNode *node) : base(base), node(node) {}
+
+        JSONObject::ValueType Type() const;
+        JSONObject::JSONArray::Storage GetStorage() const;
+
+        s32 AsInt() const;
+        f64 AsDouble() const;
+        std::string_view AsStr() const;
+
+        /**
+         * @return number of members of an object or elements of an array, 0 otherwise
+         */
+        u64 Size() const;
+
+        SnapshotValue operator[](u64 index) const;
+        SnapshotValue operator[](std::string_view key) const;
+        SnapshotValue operator[](const char *key) const { return (*this)[std::string_view(key)]; }
+        SnapshotValue operator[](const Key& key) const;
+
+        /**
+         * @brief members of an object in insertion order
+         */
+        std::string_view KeyAt(u64 index) const;
+        SnapshotValue ValueAt(u64 index) const;
+
+        /**
+         * @return the elements of a packed array, straight from the mapping
+         */
+        Span<const s32> Ints() const;
+        Span<const f64> Doubles() const;
+
+        /**
+         * @brief copies the value out of the snapshot into a regular JSONValue
+         */
+        JSONObject::JSONValue Materialize() const;
+
+    private:
+        const u8 *base;
+        const SnapshotNode *node;
+
+        SnapshotValue Find(std::string_view key, u64 hash) const;
+        const SnapshotMember* Members() const;
+    };
+
+    class Snapshot
+    {
+    public:
+        static const u32 version = 1;
+
+        /**
+         * @brief objects with more members than this get a hash sorted slot index
+         */
+        static const u64 linear_lookup_max = 8;
+
+        Snapshot() : data(nullptr), size(0), mapped(0) {}
+        ~Snapshot();
+
+        Snapshot(const Snapshot& other) = delete;
+        Snapshot& operator=(const Snapshot& other) = delete;
+
+        /**
+         * @brief maps the snapshot file at path read only
+         * @return 1 on success, 0 if the file can't be mapped or its header is invalid
+         */
+        b8 Open(const std::string& path);
+
+        /**
+         * @brief uses a snapshot that is already in memory, 8 byte aligned. the memory
+         *        is not copied and must outlive the Snapshot
+         */
+        b8 Load(const u8 *data, u64 size);
+
+        void Close();
+
+        SnapshotValue Root() const;
+
+    private:
+        const u8 *data;
+        u64 size;
+        b8 mapped;
+
+        b8 Validate() const;
+    };
+
+    /**
+     * NOTE(19.10.26): an immutable copy of a document, laid out like a snapshot in one
+     * buffer it owns. JSONValue accessors hand out mutable references, bad_value is
+     * shared and bodies carry reference counts and a lazily cached hash, so readers of
+     * one JSONObject on several threads have no guarantees. nothing writes to a frozen
+     * document after Freeze, SnapshotValue only hands out values and views, so any
+     * number of threads read it at once without locks or atomics. objects with more
+     * than Snapshot::linear_lookup_max members come with their slot index built.
+     *
+     * usage:   FrozenDocument frozen = FrozenDocument::Freeze(config);
+     *          s32 port = frozen.Root()["server"]["port"].AsInt();
+     */
+    class FrozenDocument
+    {
+    public:
+        FrozenDocument() = default;
+        FrozenDocument(FrozenDocument&& other) = default;
+        FrozenDocument& operator=(FrozenDocument&& other) = default;
+
+        FrozenDocument(const FrozenDocument& other) = delete;
+        FrozenDocument& operator=(const FrozenDocument& other) = delete;
+
+        static FrozenDocument Freeze(const JSONObject& root);
+
+        /**
+         * @return the root object, a BAD_TYPE value if nothing was frozen
+         */
+        SnapshotValue Root() const;
+
+        /**
+         * @brief the frozen document is a valid snapshot, it can be written out as is
+         */
+        const std::vector<u8>& Bytes() const { return bytes; }
+
+    private:
+        std::vector<u8> bytes;
+    };
+}
+
+#endif /* __SNAPSHOT_H__ */
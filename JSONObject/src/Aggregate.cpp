@@ -0,0 +1,486 @@
+/* ------------------------------------------*/
+/* Filename: Aggregate.cpp                   */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <limits>
+
+#include "Aggregate.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define JSORON_AVX2
+#include <immintrin.h>
+#endif /* __GNUC__ && __x86_64__ */
+
+namespace JSORON
+{
+
+namespace
+{
+    // NOTE(19.10.26): two AVX2 registers of doubles, the scalar kernels keep the same
+    // number of partial sums so both round the same way
+    const u64 lanes = 8;
+    const u64 gather_size = 256;
+    const f64 infinity = std::numeric_limits<f64>::infinity();
+
+    Summary EmptySummary()
+    {
+        return Summary{0, 0, infinity, -infinity};
+    }
+
+    void Merge(Summary& into, const Summary& from)
+    {
+        into.count += from.count;
+        into.sum += from.sum;
+        into.min = std::min(into.min, from.min);
+        into.max = std::max(into.max, from.max);
+    }
+
+    b8 NumberOf(const JSONValue& value, f64& out)
+    {
+        switch (value.type)
+        {
+            case JSONObject::ValueType::INT:
+            {
+                out = value.int_val;
+                return 1;
+            }
+
+            case JSONObject::ValueType::DOUBLE:
+            {
+                out = value.double_val;
+                return 1;
+            }
+
+            default:
+            {
+            } break;
+        }
+
+        return 0;
+    }
+
+    Summary SummarizeDoublesScalar(const f64 *data, u64 size)
+    {
+        f64 sums[lanes] = {};
+        f64 min = infinity;
+        f64 max = -infinity;
+        u64 index = 0;
+        for (; index + lanes <= size; index += lanes)
+        {
+            for (u64 lane = 0; lane < lanes; ++lane)
+            {
+                sums[lane] += data[index + lane];
+                min = std::min(min, data[index + lane]);
+                max = std::max(max, data[index + lane]);
+            }
+        }
+
+        f64 sum = ((sums[0] + sums[4]) + (sums[2] + sums[6])) + ((sums[1] + sums[5]) + (sums[3] + sums[7]));
+        for (; index < size; ++index)
+        {
+            sum += data[index];
+            min = std::min(min, data[index]);
+            max = std::max(max, data[index]);
+        }
+
+        return Summary{size, sum, min, max};
+    }
+
+    Summary SummarizeIntsScalar(const s32 *data, u64 size)
+    {
+        s64 sum = 0;
+        s32 min = std::numeric_limits<s32>::max();
+        s32 max = std::numeric_limits<s32>::min();
+        for (u64 index = 0; index < size; ++index)
+        {
+            sum += data[index];
+            min = std::min(min, data[index]);
+            max = std::max(max, data[index]);
+        }
+
+        return size ? Summary{size, (f64)sum, (f64)min, (f64)max} : EmptySummary();
+    }
+
+    template<typename T>
+    u64 HistogramScalar(const T *data, u64 size, f64 low, f64 high, f64 scale, Span<u64> bins)
+    {
+        u64 last = bins.Size() - 1;
+        u64 counted = 0;
+        for (u64 index = 0; index < size; ++index)
+        {
+            f64 num = data[index];
+            if (num >= low && num < high)
+            {
+                // NOTE(19.10.26): a value just below high can round up into the bin past the end
+                u64 bin = (u64)((num - low) * scale);
+                ++bins[std::min(bin, last)];
+                ++counted;
+            }
+        }
+
+        return counted;
+    }
+
+#ifdef JSORON_AVX2
+    __attribute__((target("avx2")))
+    Summary SummarizeDoublesAVX2(const f64 *data, u64 size)
+    {
+        __m256d sums_low = _mm256_setzero_pd();
+        __m256d sums_high = _mm256_setzero_pd();
+        __m256d mins = _mm256_set1_pd(infinity);
+        __m256d maxs = _mm256_set1_pd(-infinity);
+        u64 index = 0;
+        for (; index + lanes <= size; index += lanes)
+        {
+            __m256d low = _mm256_loadu_pd(data + index);
+            __m256d high = _mm256_loadu_pd(data + index + 4);
+            sums_low = _mm256_add_pd(sums_low, low);
+            sums_high = _mm256_add_pd(sums_high, high);
+            mins = _mm256_min_pd(mins, _mm256_min_pd(low, high));
+            maxs = _mm256_max_pd(maxs, _mm256_max_pd(low, high));
+        }
+
+        __m256d sums = _mm256_add_pd(sums_low, sums_high);
+        __m128d halves = _mm_add_pd(_mm256_castpd256_pd128(sums), _mm256_extractf128_pd(sums, 1));
+        f64 sum = _mm_cvtsd_f64(halves) + _mm_cvtsd_f64(_mm_unpackhi_pd(halves, halves));
+
+        f64 min_lanes[4];
+        f64 max_lanes[4];
+        _mm256_storeu_pd(min_lanes, mins);
+        _mm256_storeu_pd(max_lanes, maxs);
+        f64 min = std::min(std::min(min_lanes[0], min_lanes[1]), std::min(min_lanes[2], min_lanes[3]));
+        f64 max = std::max(std::max(max_lanes[0], max_lanes[1]), std::max(max_lanes[2], max_lanes[3]));
+        for (; index < size; ++index)
+        {
+            sum += data[index];
+            min = std::min(min, data[index]);
+            max = std::max(max, data[index]);
+        }
+
+        return Summary{size, sum, min, max};
+    }
+
+    __attribute__((target("avx2")))
+    Summary SummarizeIntsAVX2(const s32 *data, u64 size)
+    {
+        __m256i sums_low = _mm256_setzero_si256();
+        __m256i sums_high = _mm256_setzero_si256();
+        __m256i mins = _mm256_set1_epi32(std::numeric_limits<s32>::max());
+        __m256i maxs = _mm256_set1_epi32(std::numeric_limits<s32>::min());
+        u64 index = 0;
+        for (; index + lanes <= size; index += lanes)
+        {
+            __m256i nums = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+            mins = _mm256_min_epi32(mins, nums);
+            maxs = _mm256_max_epi32(maxs, nums);
+
+            // NOTE(19.10.26): widened to 64 bits before adding, the sum can't overflow
+            sums_low = _mm256_add_epi64(sums_low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(nums)));
+            sums_high = _mm256_add_epi64(sums_high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(nums, 1)));
+        }
+
+        s64 sum_lanes[4];
+        s32 min_lanes[8];
+        s32 max_lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sum_lanes), _mm256_add_epi64(sums_low, sums_high));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(min_lanes), mins);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(max_lanes), maxs);
+
+        s64 sum = sum_lanes[0] + sum_lanes[1] + sum_lanes[2] + sum_lanes[3];
+        s32 min = *std::min_element(min_lanes, min_lanes + 8);
+        s32 max = *std::max_element(max_lanes, max_lanes + 8);
+        for (; index < size; ++index)
+        {
+            sum += data[index];
+            min = std::min(min, data[index]);
+            max = std::max(max, data[index]);
+        }
+
+        return size ? Summary{size, (f64)sum, (f64)min, (f64)max} : EmptySummary();
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256d Load4(const f64 *data)
+    {
+        return _mm256_loadu_pd(data);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256d Load4(const s32 *data)
+    {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+
+    /**
+     * the bins of four values are found at once, the counts are incremented one by one,
+     * AVX2 has no scatter
+     */
+    template<typename T>
+    __attribute__((target("avx2")))
+    u64 HistogramAVX2(const T *data, u64 size, f64 low, f64 high, f64 scale, Span<u64> bins)
+    {
+        __m256d lows = _mm256_set1_pd(low);
+        __m256d highs = _mm256_set1_pd(high);
+        __m256d scales = _mm256_set1_pd(scale);
+        __m128i last = _mm_set1_epi32((s32)(bins.Size() - 1));
+        u64 counted = 0;
+        u64 index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d nums = Load4(data + index);
+            __m256d inside = _mm256_and_pd(_mm256_cmp_pd(nums, lows, _CMP_GE_OQ), _mm256_cmp_pd(nums, highs, _CMP_LT_OQ));
+            s32 mask = _mm256_movemask_pd(inside);
+            if (!mask)
+            {
+                continue;
+            }
+
+            __m128i bin = _mm_min_epi32(_mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_sub_pd(nums, lows), scales)), last);
+            alignas(16) s32 at[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(at), bin);
+            for (u64 lane = 0; lane < 4; ++lane)
+            {
+                if (mask & (1 << lane))
+                {
+                    ++bins[at[lane]];
+                    ++counted;
+                }
+            }
+        }
+
+        return counted + HistogramScalar(data + index, size - index, low, high, scale, bins);
+    }
+#endif /* JSORON_AVX2 */
+
+    b8 UseAVX2(AggregateKernel kernel)
+    {
+        return kernel != AggregateKernel::SCALAR && HasAVX2Kernels();
+    }
+
+    Summary SummarizeDoubles(const f64 *data, u64 size, AggregateKernel kernel)
+    {
+#ifdef JSORON_AVX2
+        if (UseAVX2(kernel))
+        {
+            return SummarizeDoublesAVX2(data, size);
+        }
+#endif /* JSORON_AVX2 */
+
+        return SummarizeDoublesScalar(data, size);
+    }
+
+    Summary SummarizeInts(const s32 *data, u64 size, AggregateKernel kernel)
+    {
+#ifdef JSORON_AVX2
+        if (UseAVX2(kernel))
+        {
+            return SummarizeIntsAVX2(data, size);
+        }
+#endif /* JSORON_AVX2 */
+
+        return SummarizeIntsScalar(data, size);
+    }
+
+    template<typename T>
+    u64 HistogramOf(const T *data, u64 size, f64 low, f64 high, Span<u64> bins, AggregateKernel kernel)
+    {
+        f64 scale = bins.Size() / (high - low);
+#ifdef JSORON_AVX2
+        if (UseAVX2(kernel) && bins.Size() <= (u64)std::numeric_limits<s32>::max())
+        {
+            return HistogramAVX2(data, size, low, high, scale, bins);
+        }
+#endif /* JSORON_AVX2 */
+
+        return HistogramScalar(data, size, low, high, scale, bins);
+    }
+
+    /**
+     * @brief reads the numbers of a GENERIC array through read(value, out) into a buffer
+     *        and hands every full buffer, and the rest at the end, to consume(data, size)
+     */
+    template<typename Read, typename Consume>
+    void Gather(const JSONArray& arr, Read&& read, Consume&& consume)
+    {
+        f64 buffer[gather_size];
+        u64 size = 0;
+        for (u64 index = 0; index < arr.Size(); ++index)
+        {
+            if (read(arr.At(index), buffer[size]) && ++size == gather_size)
+            {
+                consume(buffer, size);
+                size = 0;
+            }
+        }
+
+        if (size)
+        {
+            consume(buffer, size);
+        }
+    }
+
+    /**
+     * @return a reader of key from the object elements of an array
+     */
+    auto FieldOf(const Key& key)
+    {
+        return [&key](const JSONValue& value, f64& out)
+        {
+            return value.type == JSONObject::ValueType::JSON_OBJECT && NumberOf((*value.json_val)[key], out);
+        };
+    }
+}
+
+b8 HasAVX2Kernels()
+{
+#ifdef JSORON_AVX2
+    static const b8 has_avx2 = __builtin_cpu_supports("avx2") != 0;
+    return has_avx2;
+#else
+    return 0;
+#endif /* JSORON_AVX2 */
+}
+
+Summary Summarize(const JSONArray& arr, AggregateKernel kernel)
+{
+    Summary summary = EmptySummary();
+    switch (arr.GetStorage())
+    {
+        case JSONArray::Storage::INTS:
+        {
+            Span<const s32> ints = arr.Ints();
+            summary = SummarizeInts(ints.Data(), ints.Size(), kernel);
+        } break;
+
+        case JSONArray::Storage::DOUBLES:
+        {
+            Span<const f64> doubles = arr.Doubles();
+            summary = SummarizeDoubles(doubles.Data(), doubles.Size(), kernel);
+        } break;
+
+        case JSONArray::Storage::GENERIC:
+        {
+            Gather(arr, NumberOf, [&](const f64 *data, u64 size)
+            {
+                Merge(summary, SummarizeDoubles(data, size, kernel));
+            });
+        } break;
+
+        case JSONArray::Storage::TABLE:
+        {
+            // NOTE(19.10.26): the rows are objects, there are no numbers to summarize
+        } break;
+    }
+
+    return summary;
+}
+
+Summary Summarize(const JSONArray& arr, const Key& key, AggregateKernel kernel)
+{
+    Summary summary = EmptySummary();
+    switch (arr.GetStorage())
+    {
+        case JSONArray::Storage::TABLE:
+        {
+            const JSONArray *column = arr.Column(key);
+            if (column)
+            {
+                summary = Summarize(*column, kernel);
+            }
+        } break;
+
+        case JSONArray::Storage::GENERIC:
+        {
+            Gather(arr, FieldOf(key), [&](const f64 *data, u64 size)
+            {
+                Merge(summary, SummarizeDoubles(data, size, kernel));
+            });
+        } break;
+
+        case JSONArray::Storage::INTS:
+        case JSONArray::Storage::DOUBLES:
+        {
+        } break;
+    }
+
+    return summary;
+}
+
+u64 Histogram(const JSONArray& arr, f64 low, f64 high, Span<u64> bins, AggregateKernel kernel)
+{
+    if (bins.Size() == 0 || !(low < high))
+    {
+        return 0;
+    }
+
+    u64 counted = 0;
+    switch (arr.GetStorage())
+    {
+        case JSONArray::Storage::INTS:
+        {
+            Span<const s32> ints = arr.Ints();
+            counted = HistogramOf(ints.Data(), ints.Size(), low, high, bins, kernel);
+        } break;
+
+        case JSONArray::Storage::DOUBLES:
+        {
+            Span<const f64> doubles = arr.Doubles();
+            counted = HistogramOf(doubles.Data(), doubles.Size(), low, high, bins, kernel);
+        } break;
+
+        case JSONArray::Storage::GENERIC:
+        {
+            Gather(arr, NumberOf, [&](const f64 *data, u64 size)
+            {
+                counted += HistogramOf(data, size, low, high, bins, kernel);
+            });
+        } break;
+
+        case JSONArray::Storage::TABLE:
+        {
+        } break;
+    }
+
+    return counted;
+}
+
+u64 Histogram(const JSONArray& arr, const Key& key, f64 low, f64 high, Span<u64> bins, AggregateKernel kernel)
+{
+    if (bins.Size() == 0 || !(low < high))
+    {
+        return 0;
+    }
+
+    u64 counted = 0;
+    switch (arr.GetStorage())
+    {
+        case JSONArray::Storage::TABLE:
+        {
+            const JSONArray *column = arr.Column(key);
+            if (column)
+            {
+                counted = Histogram(*column, low, high, bins, kernel);
+            }
+        } break;
+
+        case JSONArray::Storage::GENERIC:
+        {
+            Gather(arr, FieldOf(key), [&](const f64 *data, u64 size)
+            {
+                counted += HistogramOf(data, size, low, high, bins, kernel);
+            });
+        } break;
+
+        case JSONArray::Storage::INTS:
+        case JSONArray::Storage::DOUBLES:
+        {
+        } break;
+    }
+
+    return counted;
+}
+
+} // namespace JSORON
@@ -0,0 +1,588 @@
+/* ------------------------------------------*/
+/* Filename: CBOR.cpp                        */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "CBOR.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    enum MajorType : u8
+    {
+        UNSIGNED_INT = 0,
+        NEGATIVE_INT = 1,
+        BYTE_STRING = 2,
+        TEXT_STRING = 3,
+        ARRAY = 4,
+        MAP = 5,
+        TAG = 6,
+        SIMPLE = 7
+    };
+
+    const u8 info_one_byte = 24;
+    const u8 info_indefinite = 31;
+
+    const u8 simple_false = 20;
+    const u8 simple_true = 21;
+    const u8 simple_null = 22;
+    const u8 simple_half = 25;
+    const u8 simple_float = 26;
+    const u8 simple_double = 27;
+
+    const u8 break_byte = 0xff;
+
+    f64 HalfToDouble(u16 half)
+    {
+        s32 exponent = (half >> 10) & 0x1f;
+        s32 mantissa = half & 0x3ff;
+
+        f64 value;
+        if (exponent == 0)
+        {
+            value = std::ldexp(mantissa, -24);
+        }
+        else if (exponent != 31)
+        {
+            value = std::ldexp(mantissa + 1024, exponent - 25);
+        }
+        else
+        {
+            value = mantissa == 0 ? std::numeric_limits<f64>::infinity() :
+                                    std::numeric_limits<f64>::quiet_NaN();
+        }
+
+        return half & 0x8000 ? -value : value;
+    }
+}
+
+/**************************************************************************************************
+ *
+ *  CBOREncoder
+ *
+ **************************************************************************************************/
+
+void CBOREncoder::Encode(const JSONObject& obj)
+{
+    EncodeObject(obj);
+}
+
+void CBOREncoder::Encode(const JSONObject::JSONValue& value)
+{
+    switch (value.type)
+    {
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+            bytes.push_back(SIMPLE << 5 | simple_null);
+        } break;
+
+        case JSONObject::ValueType::INT:
+        {
+            EncodeInt(value.int_val);
+        } break;
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            EncodeDouble(value.double_val);
+        } break;
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            EncodeString(value.str_val);
+        } break;
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            EncodeObject(*value.json_val);
+        } break;
+
+        case JSONObject::ValueType::ARR:
+        {
+            EncodeArray(value.json_arr);
+        } break;
+    }
+}
+
+void CBOREncoder::EncodeObject(const JSONObject& obj)
+{
+    EncodeHead(MAP, obj.Size());
+    for (const JSONObject::Entry<const JSONValue>& member : obj)
+    {
+        EncodeString(member.key);
+        Encode(member.value);
+    }
+}
+
+void CBOREncoder::EncodeArray(const JSONObject::JSONArray& arr)
+{
+    EncodeHead(ARRAY, arr.Size());
+    switch (arr.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            for (s32 num : arr.Ints())
+            {
+                EncodeInt(num);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            for (f64 num : arr.Doubles())
+            {
+                EncodeDouble(num);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            for (const JSONObject::JSONValue& value : arr)
+            {
+                Encode(value);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            Span<const JSONObject::JSONArray::TableColumn> columns = arr.Columns();
+            for (u64 row = 0; row < arr.Size(); ++row)
+            {
+                EncodeHead(MAP, columns.Size());
+                for (const JSONObject::JSONArray::TableColumn& column : columns)
+                {
+                    EncodeString(column.key);
+                    Encode(column.values.ValueAt(row));
+                }
+            }
+        } break;
+    }
+}
+
+void CBOREncoder::EncodeInt(s64 num)
+{
+    if (num >= 0)
+    {
+        EncodeHead(UNSIGNED_INT, num);
+    }
+    else
+    {
+        EncodeHead(NEGATIVE_INT, (u64)(-(num + 1)));
+    }
+}
+
+void CBOREncoder::EncodeDouble(f64 num)
+{
+    f32 narrow = (f32)num;
+    if ((f64)narrow == num || num != num)
+    {
+        u32 bits;
+        std::memcpy(&bits, &narrow, sizeof(bits));
+        u8 head[5] = {SIMPLE << 5 | simple_float,
+                      (u8)(bits >> 24), (u8)(bits >> 16), (u8)(bits >> 8), (u8)bits};
+        bytes.insert(bytes.end(), head, head + sizeof(head));
+        return;
+    }
+
+    u64 bits;
+    std::memcpy(&bits, &num, sizeof(bits));
+    u8 head[9] = {SIMPLE << 5 | simple_double,
+                  (u8)(bits >> 56), (u8)(bits >> 48), (u8)(bits >> 40), (u8)(bits >> 32),
+                  (u8)(bits >> 24), (u8)(bits >> 16), (u8)(bits >> 8), (u8)bits};
+    bytes.insert(bytes.end(), head, head + sizeof(head));
+}
+
+void CBOREncoder::EncodeString(std::string_view str)
+{
+    EncodeHead(TEXT_STRING, str.size());
+    bytes.insert(bytes.end(), str.begin(), str.end());
+}
+
+void CBOREncoder::EncodeHead(u8 major_type, u64 argument)
+{
+    u8 head[9];
+    u8 head_size = 1;
+    u8 major = major_type << 5;
+
+    if (argument < info_one_byte)
+    {
+        head[0] = major | argument;
+    }
+    else if (argument <= 0xff)
+    {
+        head[0] = major | info_one_byte;
+        head_size = 2;
+    }
+    else if (argument <= 0xffff)
+    {
+        head[0] = major | (info_one_byte + 1);
+        head_size = 3;
+    }
+    else if (argument <= 0xffffffff)
+    {
+        head[0] = major | (info_one_byte + 2);
+        head_size = 5;
+    }
+    else
+    {
+        head[0] = major | (info_one_byte + 3);
+        head_size = 9;
+    }
+
+    for (u8 index = 1; index < head_size; ++index)
+    {
+        head[index] = (u8)(argument >> (8 * (head_size - 1 - index)));
+    }
+    bytes.insert(bytes.end(), head, head + head_size);
+}
+
+/**************************************************************************************************
+ *
+ *  CBORDecoder
+ *
+ **************************************************************************************************/
+
+JSONObject CBORDecoder::Decode(const u8 *data, u64 size)
+{
+    at = data;
+    end = data + size;
+    depth = 0;
+    failed = 0;
+
+    if (at == end || (*at >> 5) != MAP)
+    {
+        failed = 1;
+        return JSONObject();
+    }
+
+    JSONObject::JSONValue root = DecodeValue();
+    if (failed || at != end)
+    {
+        failed = 1;
+        return JSONObject();
+    }
+
+    return std::move(*root.json_val);
+}
+
+JSONObject::JSONValue CBORDecoder::Fail()
+{
+    failed = 1;
+    return JSONObject::JSONValue(JSONObject::ValueType::BAD_TYPE);
+}
+
+b8 CBORDecoder::ReadArgument(u8 info, u64& argument)
+{
+    if (info < info_one_byte)
+    {
+        argument = info;
+        return 1;
+    }
+
+    if (info > info_one_byte + 3)
+    {
+        return 0;
+    }
+
+    u64 num_bytes = (u64)1 << (info - info_one_byte);
+    if ((u64)(end - at) < num_bytes)
+    {
+        return 0;
+    }
+
+    argument = 0;
+    for (u64 index = 0; index < num_bytes; ++index)
+    {
+        argument = argument << 8 | at[index];
+    }
+    at += num_bytes;
+
+    return 1;
+}
+
+b8 CBORDecoder::IsBreak()
+{
+    if (at == end)
+    {
+        failed = 1;
+        return 1;
+    }
+
+    if (*at == break_byte)
+    {
+        ++at;
+        return 1;
+    }
+
+    return 0;
+}
+
+b8 CBORDecoder::ReadString(u8 initial, std::string& str)
+{
+    u8 info = initial & 0x1f;
+    if (info == info_indefinite)
+    {
+        while (!IsBreak())
+        {
+            u8 chunk = *at++;
+            if ((chunk >> 5) != TEXT_STRING || (chunk & 0x1f) == info_indefinite ||
+                !ReadString(chunk, str))
+            {
+                return 0;
+            }
+        }
+
+        return !failed;
+    }
+
+    u64 size;
+    if (!ReadArgument(info, size) || size > (u64)(end - at))
+    {
+        return 0;
+    }
+
+    str.append(reinterpret_cast<const char*>(at), size);
+    at += size;
+
+    return 1;
+}
+
+JSONObject::JSONValue CBORDecoder::DecodeValue()
+{
+    if (at == end)
+    {
+        return Fail();
+    }
+
+    u8 initial = *at++;
+    u8 info = initial & 0x1f;
+    u64 argument = 0;
+
+    switch (initial >> 5)
+    {
+        case UNSIGNED_INT:
+        {
+            if (!ReadArgument(info, argument))
+            {
+                return Fail();
+            }
+
+            if (argument <= (u64)std::numeric_limits<s32>::max())
+            {
+                return JSONObject::JSONValue((s32)argument);
+            }
+            return JSONObject::JSONValue((f64)argument);
+        }
+
+        case NEGATIVE_INT:
+        {
+            if (!ReadArgument(info, argument))
+            {
+                return Fail();
+            }
+
+            if (argument <= (u64)std::numeric_limits<s32>::max())
+            {
+                return JSONObject::JSONValue((s32)(-1 - (s64)argument));
+            }
+            return JSONObject::JSONValue(-1.0 - (f64)argument);
+        }
+
+        case TEXT_STRING:
+        {
+            std::string str;
+            if (!ReadString(initial, str))
+            {
+                return Fail();
+            }
+            return JSONObject::JSONValue(std::move(str));
+        }
+
+        case ARRAY:
+        {
+            return DecodeArray(info);
+        }
+
+        case MAP:
+        {
+            return DecodeObject(info);
+        }
+
+        case TAG:
+        {
+            if (!ReadArgument(info, argument) || depth == max_depth)
+            {
+                return Fail();
+            }
+
+            ++depth;
+            JSONObject::JSONValue tagged = DecodeValue();
+            --depth;
+
+            return tagged;
+        }
+
+        case SIMPLE:
+        {
+            switch (info)
+            {
+                case simple_false:
+                case simple_true:
+                {
+                    return JSONObject::JSONValue((s32)(info == simple_true));
+                }
+
+                case simple_null:
+                {
+                    return JSONObject::JSONValue();
+                }
+
+                case simple_half:
+                case simple_float:
+                case simple_double:
+                {
+                    if (!ReadArgument(info, argument))
+                    {
+                        return Fail();
+                    }
+
+                    if (info == simple_half)
+                    {
+                        return JSONObject::JSONValue(HalfToDouble((u16)argument));
+                    }
+
+                    if (info == simple_float)
+                    {
+                        u32 bits = (u32)argument;
+                        f32 narrow;
+                        std::memcpy(&narrow, &bits, sizeof(narrow));
+                        return JSONObject::JSONValue((f64)narrow);
+                    }
+
+                    f64 num;
+                    std::memcpy(&num, &argument, sizeof(num));
+                    return JSONObject::JSONValue(num);
+                }
+            }
+
+            return Fail();
+        }
+    }
+
+    // byte strings
+    return Fail();
+}
+
+JSONObject::JSONValue CBORDecoder::DecodeArray(u8 info)
+{
+    if (depth == max_depth)
+    {
+        return Fail();
+    }
+    ++depth;
+
+    JSONObject::JSONArray arr;
+    if (info == info_indefinite)
+    {
+        while (!IsBreak())
+        {
+            JSONObject::JSONValue value = DecodeValue();
+            if (failed)
+            {
+                return Fail();
+            }
+            arr.PushBack(std::move(value));
+        }
+    }
+    else
+    {
+        u64 count;
+        if (!ReadArgument(info, count))
+        {
+            return Fail();
+        }
+
+        for (u64 index = 0; index < count; ++index)
+        {
+            JSONObject::JSONValue value = DecodeValue();
+            if (failed)
+            {
+                return Fail();
+            }
+            arr.PushBack(std::move(value));
+
+            // NOTE(19.10.26): after the first element, which picks the packed storage.
+            // every element takes at least a byte, so a lying count can't over-allocate
+            if (index == 0)
+            {
+                arr.Reserve(std::min(count, (u64)(end - at) + 1));
+            }
+        }
+    }
+
+    --depth;
+    if (failed)
+    {
+        return Fail();
+    }
+
+    return JSONObject::JSONValue(std::move(arr));
+}
+
+JSONObject::JSONValue CBORDecoder::DecodeObject(u8 info)
+{
+    if (depth == max_depth)
+    {
+        return Fail();
+    }
+    ++depth;
+
+    u64 count = 0;
+    b8 indefinite = info == info_indefinite;
+    if (!indefinite && !ReadArgument(info, count))
+    {
+        return Fail();
+    }
+
+    JSONObject obj;
+    for (u64 index = 0; indefinite ? !IsBreak() : index < count; ++index)
+    {
+        if (at == end || (*at >> 5) != TEXT_STRING)
+        {
+            return Fail();
+        }
+
+        std::string key;
+        if (!ReadString(*at++, key))
+        {
+            return Fail();
+        }
+
+        JSONObject::JSONValue value = DecodeValue();
+        if (failed)
+        {
+            return Fail();
+        }
+        obj.Put(std::move(key), std::move(value));
+    }
+
+    --depth;
+    if (failed)
+    {
+        return Fail();
+    }
+
+    return JSONObject::JSONValue(std::move(obj));
+}
+
+} // namespace JSORON
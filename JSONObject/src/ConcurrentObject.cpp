@@ -0,0 +1,170 @@
+/* ------------------------------------------*/
+/* Filename: ConcurrentObject.cpp            */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "ConcurrentObject.h"
+
+namespace JSORON
+{
+
+ConcurrentObject::ConcurrentObject(u64 num_shards, Order order) : shards(), num_shards(1), shard_mask(0),
+                                                                   order(order), next_sequence(0)
+{
+    while (this->num_shards < num_shards)
+    {
+        this->num_shards <<= 1;
+    }
+
+    shard_mask = this->num_shards - 1;
+    shards.reset(new Shard[this->num_shards]);
+}
+
+template<typename K>
+b8 ConcurrentObject::Find(u64 hash, const K& key, JSONValue& out) const
+{
+    Shard& shard = ShardOf(hash);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    // NOTE(19.10.26): const lookups only, the shard is shared with other readers
+    const JSONObject& members = shard.members;
+    const JSONValue& value = members[key];
+    if (value.type == JSONObject::ValueType::BAD_TYPE)
+    {
+        return 0;
+    }
+
+    out = value;
+    return 1;
+}
+
+void ConcurrentObject::Put(std::string key, JSONValue value)
+{
+    Shard& shard = ShardOf(HashKey(key));
+    std::lock_guard<std::shared_mutex> lock(shard.mutex);
+    Slot(shard, std::move(key)) = std::move(value);
+}
+
+b8 ConcurrentObject::Get(std::string_view key, JSONValue& out) const
+{
+    return Find(HashKey(key), key, out);
+}
+
+b8 ConcurrentObject::Get(const Key& key, JSONValue& out) const
+{
+    return Find(key.Hash(), key, out);
+}
+
+b8 ConcurrentObject::Contains(std::string_view key) const
+{
+    Shard& shard = ShardOf(HashKey(key));
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    const JSONObject& members = shard.members;
+    return members[key].type != JSONObject::ValueType::BAD_TYPE;
+}
+
+b8 ConcurrentObject::Remove(std::string_view key)
+{
+    Shard& shard = ShardOf(HashKey(key));
+    std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+    if (!shard.members.Remove(key))
+    {
+        return 0;
+    }
+
+    if (order == Order::INSERTION)
+    {
+        shard.sequences.erase(std::string(key));
+    }
+
+    return 1;
+}
+
+u64 ConcurrentObject::Size() const
+{
+    u64 size = 0;
+    for (u64 index = 0; index < num_shards; ++index)
+    {
+        std::shared_lock<std::shared_mutex> lock(shards[index].mutex);
+        size += shards[index].members.Size();
+    }
+
+    return size;
+}
+
+JSONObject ConcurrentObject::ToObject() const
+{
+    JSONObject obj;
+    if (order == Order::UNORDERED)
+    {
+        for (u64 index = 0; index < num_shards; ++index)
+        {
+            // NOTE(19.10.26): the copy shares the shard's body, the members are copied
+            // outside the lock. the next write to the shard detaches it once
+            JSONObject members;
+            {
+                std::shared_lock<std::shared_mutex> lock(shards[index].mutex);
+                members = shards[index].members;
+            }
+
+            const JSONObject& shard_members = members;
+            for (const JSONObject::Entry<const JSONValue>& entry : shard_members)
+            {
+                obj.Put(std::string(entry.key), JSONValue(entry.value));
+            }
+        }
+
+        return obj;
+    }
+
+    std::vector<std::tuple<u64, std::string, JSONValue>> entries;
+    for (u64 index = 0; index < num_shards; ++index)
+    {
+        const Shard& shard = shards[index];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        const JSONObject& members = shard.members;
+        for (const std::pair<const std::string, u64>& sequence : shard.sequences)
+        {
+            entries.emplace_back(sequence.second, sequence.first, members[sequence.first]);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs)
+    {
+        return std::get<0>(lhs) < std::get<0>(rhs);
+    });
+
+    for (std::tuple<u64, std::string, JSONValue>& entry : entries)
+    {
+        obj.Put(std::move(std::get<1>(entry)), std::move(std::get<2>(entry)));
+    }
+
+    return obj;
+}
+
+JSONValue& ConcurrentObject::Slot(Shard& shard, std::string&& key)
+{
+    if (order == Order::INSERTION)
+    {
+        u64 size = shard.members.Size();
+        JSONValue& value = shard.members.Emplace(key);
+        if (shard.members.Size() != size)
+        {
+            shard.sequences.emplace(std::move(key), next_sequence.fetch_add(1, std::memory_order_relaxed));
+        }
+
+        return value;
+    }
+
+    return shard.members.Emplace(std::move(key));
+}
+
+} // namespace JSORON
@@ -0,0 +1,396 @@
+/* ------------------------------------------*/
+/* Filename: Deduplicator.cpp                */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <cstring>
+
+#include "Deduplicator.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    const u64 empty_hash = 0x3c6ef372fe94f82bull;
+
+    u64 DoubleBits(f64 num)
+    {
+        u64 bits;
+        std::memcpy(&bits, &num, sizeof(bits));
+        return bits;
+    }
+
+    /**
+     * @return bytes the string owns on the heap, 0 when it fits in the small string buffer
+     */
+    u64 StringHeapBytes(const std::string& str)
+    {
+        const char *self = reinterpret_cast<const char*>(&str);
+        if (str.data() >= self && str.data() < self + sizeof(std::string))
+        {
+            return 0;
+        }
+
+        return str.capacity() + 1;
+    }
+}
+
+void Deduplicator::Intern(JSONObject::JSONValue& value)
+{
+    const void *body = BodyOf(value);
+    if (!body)
+    {
+        return;
+    }
+
+    ++stats.containers_seen;
+    if (body_hashes.find(body) != body_hashes.end())
+    {
+        return;
+    }
+
+    // NOTE(19.10.26): candidates are compared slot by slot, an object with tombstones
+    // is left alone. so is a TABLE array, its rows are no containers of their own
+    b8 is_object = value.type == JSONObject::ValueType::JSON_OBJECT;
+    if (is_object && value.json_val->Read().num_removed)
+    {
+        return;
+    }
+
+    if (!is_object && value.json_arr.GetStorage() == JSONObject::JSONArray::Storage::TABLE)
+    {
+        return;
+    }
+
+    u64 hash = is_object ? HashObject(*value.json_val) : HashArray(value.json_arr);
+
+    auto candidates = canonical.equal_range(hash);
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+    {
+        const JSONObject::JSONValue& other = candidate->second;
+        if (other.type != value.type)
+        {
+            continue;
+        }
+
+        b8 same = is_object ? SameObject(*other.json_val, *value.json_val) :
+                              SameArray(other.json_arr, value.json_arr);
+        if (same)
+        {
+            ++stats.containers_shared;
+            stats.bytes_saved += ShallowBytes(value);
+            value = other;
+            return;
+        }
+    }
+
+    canonical.emplace(hash, value);
+    body_hashes.emplace(body, hash);
+}
+
+void Deduplicator::Clear()
+{
+    canonical.clear();
+    body_hashes.clear();
+}
+
+const void* Deduplicator::BodyOf(const JSONObject::JSONValue& value)
+{
+    if (value.type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        return value.json_val->body;
+    }
+
+    if (value.type == JSONObject::ValueType::ARR)
+    {
+        return value.json_arr.body;
+    }
+
+    return nullptr;
+}
+
+u64 Deduplicator::HashValue(const JSONObject::JSONValue& value) const
+{
+    switch (value.type)
+    {
+        case JSONObject::ValueType::INT:
+        {
+            return CombineHash((u64)value.type, (u64)(s64)value.int_val);
+        }
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            return CombineHash((u64)value.type, DoubleBits(value.double_val));
+        }
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            return CombineHash((u64)value.type, HashKey(value.str_val));
+        }
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        case JSONObject::ValueType::ARR:
+        {
+            const void *body = BodyOf(value);
+            if (!body)
+            {
+                return CombineHash((u64)value.type, empty_hash);
+            }
+
+            auto found = body_hashes.find(body);
+            if (found != body_hashes.end())
+            {
+                return found->second;
+            }
+
+            return value.type == JSONObject::ValueType::JSON_OBJECT ? HashObject(*value.json_val) :
+                                                                    HashArray(value.json_arr);
+        }
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+
+    return CombineHash((u64)value.type, empty_hash);
+}
+
+u64 Deduplicator::HashObject(const JSONObject& obj) const
+{
+    u64 hash = object_hash_seed;
+    for (const JSONObject::Member& member : obj.Read().members)
+    {
+        if (member.IsRemoved())
+        {
+            continue;
+        }
+
+        hash = CombineHash(hash, member.hash);
+        hash = CombineHash(hash, HashValue(member.value));
+    }
+
+    return hash;
+}
+
+u64 Deduplicator::HashArray(const JSONObject::JSONArray& arr) const
+{
+    u64 hash = CombineHash(array_hash_seed, (u64)arr.GetStorage());
+    switch (arr.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            for (s32 num : arr.Ints())
+            {
+                hash = CombineHash(hash, (u64)(s64)num);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            for (f64 num : arr.Doubles())
+            {
+                hash = CombineHash(hash, DoubleBits(num));
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            for (const JSONObject::JSONValue& value : arr)
+            {
+                hash = CombineHash(hash, HashValue(value));
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            for (const JSONObject::JSONArray::TableColumn& column : arr.Columns())
+            {
+                hash = CombineHash(hash, column.hash);
+                hash = CombineHash(hash, HashArray(column.values));
+            }
+        } break;
+    }
+
+    return hash;
+}
+
+b8 Deduplicator::SameValue(const JSONObject::JSONValue& lhs, const JSONObject::JSONValue& rhs)
+{
+    if (lhs.type != rhs.type)
+    {
+        return 0;
+    }
+
+    switch (lhs.type)
+    {
+        case JSONObject::ValueType::INT:
+        {
+            return lhs.int_val == rhs.int_val;
+        }
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            return DoubleBits(lhs.double_val) == DoubleBits(rhs.double_val);
+        }
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            return lhs.str_val == rhs.str_val;
+        }
+
+        // NOTE(19.10.26): children are canonical already, equal children share a body
+        case JSONObject::ValueType::JSON_OBJECT:
+        case JSONObject::ValueType::ARR:
+        {
+            return BodyOf(lhs) == BodyOf(rhs);
+        }
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+
+    return 1;
+}
+
+b8 Deduplicator::SameObject(const JSONObject& lhs, const JSONObject& rhs)
+{
+    const std::vector<JSONObject::Member>& lhs_members = lhs.Read().members;
+    const std::vector<JSONObject::Member>& rhs_members = rhs.Read().members;
+    if (lhs_members.size() != rhs_members.size())
+    {
+        return 0;
+    }
+
+    for (u64 slot = 0; slot < lhs_members.size(); ++slot)
+    {
+        const JSONObject::Member& lhs_member = lhs_members[slot];
+        const JSONObject::Member& rhs_member = rhs_members[slot];
+        if (lhs_member.hash != rhs_member.hash || lhs_member.key != rhs_member.key ||
+            !SameValue(lhs_member.value, rhs_member.value))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+b8 Deduplicator::SameArray(const JSONObject::JSONArray& lhs, const JSONObject::JSONArray& rhs)
+{
+    if (lhs.GetStorage() != rhs.GetStorage() || lhs.Size() != rhs.Size())
+    {
+        return 0;
+    }
+
+    switch (lhs.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            return std::memcmp(lhs.Ints().Data(), rhs.Ints().Data(), lhs.Size() * sizeof(s32)) == 0;
+        }
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            return std::memcmp(lhs.Doubles().Data(), rhs.Doubles().Data(), lhs.Size() * sizeof(f64)) == 0;
+        }
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            for (u64 index = 0; index < lhs.Size(); ++index)
+            {
+                if (!SameValue(lhs.At(index), rhs.At(index)))
+                {
+                    return 0;
+                }
+            }
+        } break;
+
+        // NOTE(19.10.26): tables are never interned, they are only the same as themselves
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            return lhs.body == rhs.body;
+        }
+    }
+
+    return 1;
+}
+
+u64 Deduplicator::ShallowBytes(const JSONObject::JSONValue& value)
+{
+    // NOTE(19.10.26): what is freed when the copy is dropped, its own body and what the
+    // body owns directly. the children of the copy are canonical and stay alive
+    auto value_bytes = [](const JSONObject::JSONValue& child) -> u64
+    {
+        if (child.type == JSONObject::ValueType::STR || child.type == JSONObject::ValueType::KEY)
+        {
+            return StringHeapBytes(child.str_val);
+        }
+
+        if (child.type == JSONObject::ValueType::JSON_OBJECT)
+        {
+            return sizeof(JSONObject);
+        }
+
+        return 0;
+    };
+
+    u64 num_bytes = 0;
+    if (value.type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        const JSONObject::Body& body = *value.json_val->body;
+        num_bytes += sizeof(JSONObject::Body) + body.members.capacity() * sizeof(JSONObject::Member) +
+                     body.index.capacity() * sizeof(u32);
+        for (const JSONObject::Member& member : body.members)
+        {
+            num_bytes += StringHeapBytes(member.key) + value_bytes(member.value);
+        }
+    }
+    else
+    {
+        const JSONObject::JSONArray::Body& body = *value.json_arr.body;
+        num_bytes += sizeof(JSONObject::JSONArray::Body);
+        switch (body.storage)
+        {
+            case JSONObject::JSONArray::Storage::INTS:
+            {
+                num_bytes += body.int_arr.capacity() * sizeof(s32);
+            } break;
+
+            case JSONObject::JSONArray::Storage::DOUBLES:
+            {
+                num_bytes += body.double_arr.capacity() * sizeof(f64);
+            } break;
+
+            case JSONObject::JSONArray::Storage::GENERIC:
+            {
+                num_bytes += body.array.capacity() * sizeof(JSONObject::JSONValue);
+                for (const JSONObject::JSONValue& child : body.array)
+                {
+                    num_bytes += value_bytes(child);
+                }
+            } break;
+
+            case JSONObject::JSONArray::Storage::TABLE:
+            {
+                num_bytes += body.columns.capacity() * sizeof(JSONObject::JSONArray::TableColumn);
+                for (const JSONObject::JSONArray::TableColumn& column : body.columns)
+                {
+                    num_bytes += StringHeapBytes(column.key);
+                }
+            } break;
+        }
+    }
+
+    return num_bytes;
+}
+
+} // namespace JSORON
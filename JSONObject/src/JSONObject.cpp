@@ -4,16 +4,130 @@
 /* Author:   Oron                            */ 
 /* ------------------------------------------*/
 
+#include <algorithm>
+#include <chrono>
 #include <ostream>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <assert.h>
+#include <cstring>
 
 #include "JSONObject.h"
+#include "JSONSerializer.h"
 #include "profiler.h"
 
 namespace JSORON
 {
+
+namespace
+{
+    std::mutex unpack_mutex;    // held while a const accessor copies out a packed body
+
+    u64 HashOfInt(s32 num)
+    {
+        return CombineHash((u64)JSONObject::ValueType::INT, (u64)(s64)num);
+    }
+
+    u64 HashOfDouble(f64 num)
+    {
+        // NOTE(19.10.26): 0.0 == -0.0, so they have to hash the same
+        if (num == 0)
+        {
+            num = 0;
+        }
+
+        u64 bits;
+        std::memcpy(&bits, &num, sizeof(bits));
+        return CombineHash((u64)JSONObject::ValueType::DOUBLE, bits);
+    }
+
+    /**
+     * @brief returns the cached hash, or computes it and caches it. 0 marks a hash
+     *        that was not computed yet, so a computed 0 is stored as 1
+     */
+    template<typename Compute>
+    u64 CachedHash(std::atomic<u64>& cache, Compute compute)
+    {
+        u64 hash = cache.load(std::memory_order_relaxed);
+        if (hash)
+        {
+            return hash;
+        }
+
+        hash = compute();
+        hash = hash ? hash : 1;
+        cache.store(hash, std::memory_order_relaxed);
+
+        return hash;
+    }
+
+    /**
+     * @brief stores the number in value as num, f64 takes ints too
+     * @return 0 and num = 0 if value holds no such number
+     */
+    b8 NumberOf(const JSONObject::JSONValue& value, s32& num)
+    {
+        b8 is_int = value.type == JSONObject::ValueType::INT;
+        num = is_int ? value.int_val : 0;
+        return is_int;
+    }
+
+    b8 NumberOf(const JSONObject::JSONValue& value, f64& num)
+    {
+        if (value.type == JSONObject::ValueType::DOUBLE)
+        {
+            num = value.double_val;
+            return 1;
+        }
+
+        b8 is_int = value.type == JSONObject::ValueType::INT;
+        num = is_int ? value.int_val : 0;
+        return is_int;
+    }
+
+    /**
+     * @brief copies the numbers of a column of a TABLE array into out
+     */
+    template<typename T>
+    b8 CopyColumn(const JSONObject::JSONArray& column, Span<T> out)
+    {
+        switch (column.GetStorage())
+        {
+            case JSONObject::JSONArray::Storage::INTS:
+            {
+                std::copy(column.Ints().begin(), column.Ints().end(), out.Data());
+                return 1;
+            }
+
+            case JSONObject::JSONArray::Storage::DOUBLES:
+            {
+                if (std::is_same<T, f64>::value)
+                {
+                    std::copy(column.Doubles().begin(), column.Doubles().end(), out.Data());
+                    return 1;
+                }
+            } break;
+
+            case JSONObject::JSONArray::Storage::GENERIC:
+            {
+                b8 complete = 1;
+                for (u64 index = 0; index < column.Size(); ++index)
+                {
+                    complete &= NumberOf(column.At(index), out[index]);
+                }
+                return complete;
+            }
+
+            case JSONObject::JSONArray::Storage::TABLE:
+            {
+            } break;
+        }
+
+        std::fill_n(out.Data(), column.Size(), T());
+        return column.Size() == 0;
+    }
+}
     
 /**************************************************************************************************
  * 
@@ -21,103 +135,1479 @@ namespace JSORON
  * 
  **************************************************************************************************/
 
-JSONObject::JSONValue& JSONObject::JSONArray::Iterator::operator*() const 
+JSONObject::JSONValue& JSONObject::JSONArray::Iterator::operator*() const 
+{
+    return *m_ptr;
+}
+
+JSONObject::JSONArray::Iterator& JSONObject::JSONArray::Iterator::operator++() 
+{
+    ++m_ptr;
+    
+    return *this;
+}
+
+JSONObject::JSONArray::Iterator JSONObject::JSONArray::Iterator::operator++(int) 
+{
+    Iterator temp = *this;
+    ++(*this);
+    return temp;
+}                
+
+bool JSONObject::JSONArray::Iterator::operator==(const Iterator& other) const 
+{ 
+    return m_ptr == other.m_ptr;
+}
+
+bool JSONObject::JSONArray::Iterator::operator!=(const Iterator& other) const 
+{ 
+    return !(*this == other);
+}
+
+/**************************************************************************************************
+ * 
+ *  JSONArray::ConstIterator
+ * 
+ **************************************************************************************************/
+
+const JSONObject::JSONValue& JSONObject::JSONArray::ConstIterator::operator*() const 
+{
+    return *m_ptr;
+}
+
+JSONObject::JSONArray::ConstIterator& JSONObject::JSONArray::ConstIterator::operator++() 
+{
+    ++m_ptr;
+    
+    return *this;
+}
+
+JSONObject::JSONArray::ConstIterator JSONObject::JSONArray::ConstIterator::operator++(int) 
+{
+    ConstIterator temp = *this;
+    ++(*this);
+    return temp;
+}                
+
+bool JSONObject::JSONArray::ConstIterator::operator==(const ConstIterator& other) const 
+{ 
+    return m_ptr == other.m_ptr;
+}
+
+bool JSONObject::JSONArray::ConstIterator::operator!=(const ConstIterator& other) const 
+{ 
+    return !(*this == other);
+}
+
+/**************************************************************************************************
+ * 
+ *  JSONArray
+ * 
+ **************************************************************************************************/
+
+/**
+ * NOTE(19.10.26): the field indexes of a body. each one is an open addressing table like 
+ * the member index of an object, a slot holds the low half of the mixed hash of a 
+ * value and the position of an element holding it + 1, 0 is an empty slot. a lookup 
+ * compares the values of the candidates, two values with the same hash only cost a compare.
+ */
+struct JSONObject::JSONArray::Indexes
+{
+    struct Slot
+    {
+        u32 hash;
+        u32 entry;
+    };
+
+    struct Field
+    {
+        std::string key;
+        u64 hash;
+        std::vector<Slot> slots;
+        u64 num_entries;
+        f64 build_seconds;
+
+        Key GetKey() const { return Key(key, hash); }
+    };
+
+    mutable std::mutex mutex;       // held while a stale index is rebuilt
+    std::atomic<b8> stale;
+    std::vector<Field> fields;
+
+    Indexes() : mutex(), stale(0), fields() {}
+
+    Indexes(const Indexes& other) : mutex(), stale(0), fields()
+    {
+        std::lock_guard<std::mutex> lock(other.mutex);
+        stale.store(other.stale.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        fields = other.fields;
+    }
+
+    Field* FieldFor(const Key& key)
+    {
+        for (Field& field : fields)
+        {
+            if (field.hash == key.Hash() && field.key == key.View())
+            {
+                return &field;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Build(Field& field, const Body& body)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        Reserve(field, body.Size());
+        Key key = field.GetKey();
+        JSONValue scratch;
+        for (u64 position = 0; position < body.Size(); ++position)
+        {
+            const JSONValue *value = FieldAt(body, position, key, scratch);
+            if (value)
+            {
+                Add(field, Mix(value->Hash()), position);
+            }
+        }
+
+        std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+        field.build_seconds = elapsed.count();
+    }
+
+    void Refresh(const Body& body)
+    {
+        if (!stale.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stale.load(std::memory_order_relaxed))
+        {
+            for (Field& field : fields)
+            {
+                Build(field, body);
+            }
+            stale.store(0, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief empties field and makes room for num_entries
+     */
+    static void Reserve(Field& field, u64 num_entries)
+    {
+        u64 capacity = 16;
+        while (capacity < num_entries * 2)
+        {
+            capacity *= 2;
+        }
+
+        field.slots.assign(capacity, Slot{0, 0});
+        field.num_entries = 0;
+    }
+
+    /**
+     * @brief the hashes of consecutive ints are consecutive, mixed they do not fill one 
+     *        long run of slots
+     */
+    static u64 Mix(u64 hash)
+    {
+        hash *= 0x9e3779b97f4a7c15ull;
+        return hash ^ (hash >> 32);
+    }
+
+    static void Add(Field& field, u64 hash, u64 position)
+    {
+        if ((field.num_entries + 1) * 4 > field.slots.size() * 3)
+        {
+            std::vector<Slot> slots;
+            slots.swap(field.slots);
+            Reserve(field, field.num_entries + 1);
+            for (const Slot& slot : slots)
+            {
+                if (slot.entry)
+                {
+                    Add(field, slot.hash, slot.entry - 1);
+                }
+            }
+        }
+
+        u64 mask = field.slots.size() - 1;
+        u64 at = hash & mask;
+        while (field.slots[at].entry != 0)
+        {
+            at = (at + 1) & mask;
+        }
+        field.slots[at] = Slot{(u32)hash, (u32)(position + 1)};
+        ++field.num_entries;
+    }
+
+    /**
+     * @brief removes the slot of position, the slots after it in its run move back so
+     *        no probe stops early
+     */
+    static void Remove(Field& field, u64 hash, u64 position)
+    {
+        u64 mask = field.slots.size() - 1;
+        u64 hole = hash & mask;
+        while (field.slots[hole].entry != position + 1)
+        {
+            if (field.slots[hole].entry == 0)
+            {
+                return;
+            }
+            hole = (hole + 1) & mask;
+        }
+
+        for (u64 at = (hole + 1) & mask; field.slots[at].entry != 0; at = (at + 1) & mask)
+        {
+            u64 home = field.slots[at].hash & mask;
+            if (((at - home) & mask) >= ((at - hole) & mask))
+            {
+                field.slots[hole] = field.slots[at];
+                hole = at;
+            }
+        }
+
+        field.slots[hole] = Slot{0, 0};
+        --field.num_entries;
+    }
+
+    /**
+     * @brief indexes the element just inserted at position, the ones after it move up
+     */
+    static void Inserted(Body& body, u64 position)
+    {
+        if (!body.indexes || body.indexes->stale.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        JSONValue scratch;
+        for (Field& field : body.indexes->fields)
+        {
+            if (position + 1 < body.Size())
+            {
+                for (Slot& slot : field.slots)
+                {
+                    slot.entry += slot.entry > position;
+                }
+            }
+
+            const JSONValue *value = FieldAt(body, position, field.GetKey(), scratch);
+            if (value)
+            {
+                Add(field, Mix(value->Hash()), position);
+            }
+        }
+    }
+
+    /**
+     * @brief drops the slot of element, erased from position, the ones after it move down
+     */
+    static void Erased(Body& body, u64 position, const JSONValue& element)
+    {
+        if (!body.indexes || body.indexes->stale.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        for (Field& field : body.indexes->fields)
+        {
+            const JSONValue *value = FieldOf(element, field.GetKey());
+            if (value)
+            {
+                Remove(field, Mix(value->Hash()), position);
+            }
+
+            if (position < body.Size())
+            {
+                for (Slot& slot : field.slots)
+                {
+                    slot.entry -= slot.entry > position + 1;
+                }
+            }
+        }
+    }
+
+    static void MarkStale(Body& body)
+    {
+        if (body.indexes)
+        {
+            body.indexes->stale.store(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @return position of the first element whose value at key equals value, -1 if none
+     */
+    static s64 Find(const Field& field, const Body& body, const Key& key, const JSONValue& value)
+    {
+        u64 hash = Mix(value.Hash());
+        u64 mask = field.slots.size() - 1;
+        s64 found = -1;
+        JSONValue scratch;
+        for (u64 at = hash & mask; field.slots[at].entry != 0; at = (at + 1) & mask)
+        {
+            const Slot& slot = field.slots[at];
+            s64 position = slot.entry - 1;
+            if (slot.hash != (u32)hash || (found >= 0 && position > found))
+            {
+                continue;
+            }
+
+            const JSONValue *candidate = FieldAt(body, position, key, scratch);
+            if (candidate && *candidate == value)
+            {
+                found = position;
+            }
+        }
+
+        return found;
+    }
+
+    /**
+     * @return the value at key of element, nullptr if element is no object or has none
+     */
+    static const JSONValue* FieldOf(const JSONValue& element, const Key& key)
+    {
+        if (element.type != ValueType::JSON_OBJECT)
+        {
+            return nullptr;
+        }
+
+        const JSONObject& obj = *element.json_val;
+        const JSONValue& value = obj[key];
+        return value.type == ValueType::BAD_TYPE ? nullptr : &value;
+    }
+
+    /**
+     * @return the value at key of the element at position, a value of a packed column 
+     *         is copied into scratch
+     */
+    static const JSONValue* FieldAt(const Body& body, u64 position, const Key& key, JSONValue& scratch)
+    {
+        if (body.storage == Storage::GENERIC)
+        {
+            return FieldOf(body.array[position], key);
+        }
+
+        if (body.storage != Storage::TABLE)
+        {
+            return nullptr;
+        }
+
+        for (const TableColumn& column : body.columns)
+        {
+            if (column.hash == key.Hash() && column.key == key.View())
+            {
+                if (column.values.GetStorage() == Storage::GENERIC)
+                {
+                    return &column.values.body->array[position];
+                }
+
+                scratch = column.values.ValueAt(position);
+                return &scratch;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static IndexStats StatsOf(const Field& field)
+    {
+        return IndexStats{field.num_entries, field.slots.capacity() * sizeof(Slot), field.build_seconds};
+    }
+};
+
+JSONObject::JSONArray::Body::Body(Storage storage) : ref_count(1), structural_hash(0), indexes(), unpacked(nullptr), 
+                                                     storage(storage)
+{
+    switch (storage)
+    {
+        case Storage::GENERIC:
+        {
+            new (&array) ValueArray();
+        } break;
+
+        case Storage::INTS:
+        {
+            new (&int_arr) std::vector<s32>();
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            new (&double_arr) std::vector<f64>();
+        } break;
+
+        case Storage::TABLE:
+        {
+            new (&columns) std::vector<TableColumn>();
+        } break;
+    }
+}
+
+JSONObject::JSONArray::Body::Body(const Body& other) : ref_count(1), structural_hash(0), 
+                                                        indexes(other.indexes ? new Indexes(*other.indexes) : nullptr),
+                                                        unpacked(nullptr), storage(other.storage)
+{
+    switch (storage)
+    {
+        case Storage::GENERIC:
+        {
+            new (&array) ValueArray(other.array);
+        } break;
+
+        case Storage::INTS:
+        {
+            new (&int_arr) std::vector<s32>(other.int_arr);
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            new (&double_arr) std::vector<f64>(other.double_arr);
+        } break;
+
+        case Storage::TABLE:
+        {
+            new (&columns) std::vector<TableColumn>(other.columns);
+        } break;
+    }
+}
+
+JSONObject::JSONArray::Body::~Body()
+{
+    delete unpacked.load(std::memory_order_relaxed);
+
+    switch (storage)
+    {
+        case Storage::GENERIC:
+        {
+            array.~ValueArray();
+        } break;
+
+        case Storage::INTS:
+        {
+            int_arr.~vector<s32>();
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            double_arr.~vector<f64>();
+        } break;
+
+        case Storage::TABLE:
+        {
+            columns.~vector<TableColumn>();
+        } break;
+    }
+}
+
+u64 JSONObject::JSONArray::Body::Size() const
+{
+    switch (storage)
+    {
+        case Storage::INTS:
+        {
+            return int_arr.size();
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            return double_arr.size();
+        } break;
+
+        case Storage::TABLE:
+        {
+            return columns.empty() ? 0 : columns[0].values.Size();
+        } break;
+
+        case Storage::GENERIC:
+        default:
+        {
+            return array.size();
+        } break;
+    }
+}
+
+void JSONObject::JSONArray::Body::ToGeneric()
+{
+    if (storage == Storage::GENERIC)
+    {
+        return;
+    }
+
+    ValueArray generic;
+    generic.reserve(Size());
+    if (storage == Storage::INTS)
+    {
+        for (s32 value : int_arr)
+        {
+            generic.emplace_back(value);
+        }
+        int_arr.~vector<s32>();
+    }
+    else if (storage == Storage::DOUBLES)
+    {
+        for (f64 value : double_arr)
+        {
+            generic.emplace_back(value);
+        }
+        double_arr.~vector<f64>();
+    }
+    else
+    {
+        for (u64 row = 0; row < Size(); ++row)
+        {
+            generic.emplace_back(RowView(&columns, row).Materialize());
+        }
+        columns.~vector<TableColumn>();
+    }
+
+    storage = Storage::GENERIC;
+    new (&array) ValueArray(std::move(generic));
+}
+
+void JSONObject::JSONArray::Body::Append(JSONValue&& value)
+{
+    if (storage == Storage::GENERIC && array.empty())
+    {
+        if (value.type == ValueType::INT)
+        {
+            array.~ValueArray();
+            storage = Storage::INTS;
+            new (&int_arr) std::vector<s32>();
+        }
+        else if (value.type == ValueType::DOUBLE)
+        {
+            array.~ValueArray();
+            storage = Storage::DOUBLES;
+            new (&double_arr) std::vector<f64>();
+        }
+    }
+
+    if (storage == Storage::INTS && value.type == ValueType::INT)
+    {
+        int_arr.push_back(value.int_val);
+        return;
+    }
+
+    if (storage == Storage::DOUBLES && value.type == ValueType::DOUBLE)
+    {
+        double_arr.push_back(value.double_val);
+        return;
+    }
+
+    if (storage == Storage::TABLE && FitsTable(value))
+    {
+        const JSONObject::Body& row = value.json_val->Read();
+        if (columns.empty())
+        {
+            columns.reserve(row.Size());
+            for (const Member& member : row.members)
+            {
+                if (!member.IsRemoved())
+                {
+                    columns.push_back(TableColumn{member.key, member.hash, JSONArray()});
+                }
+            }
+        }
+
+        u64 column = 0;
+        for (const Member& member : row.members)
+        {
+            if (!member.IsRemoved())
+            {
+                columns[column++].values.PushBack(JSONValue(member.value));
+            }
+        }
+        return;
+    }
+
+    ToGeneric();
+    array.push_back(std::move(value));
+}
+
+b8 JSONObject::JSONArray::Body::FitsTable(const JSONValue& value) const
+{
+    if (value.type != ValueType::JSON_OBJECT)
+    {
+        return 0;
+    }
+
+    const JSONObject::Body& row = value.json_val->Read();
+    if (columns.empty())
+    {
+        return row.Size() > 0;
+    }
+
+    if (row.Size() != columns.size())
+    {
+        return 0;
+    }
+
+    u64 column = 0;
+    for (const Member& member : row.members)
+    {
+        if (member.IsRemoved())
+        {
+            continue;
+        }
+
+        if (member.hash != columns[column].hash || member.key != columns[column].key)
+        {
+            return 0;
+        }
+        ++column;
+    }
+
+    return 1;
+}
+
+JSONObject::JSONArray::JSONArray(Storage storage) : body(new Body(storage))
+{
+}
+
+JSONObject::JSONArray::JSONArray(const JSONObject::JSONArray& other) : body(other.body)
+{
+    if (body)
+    {
+        ++body->ref_count;
+    }
+}
+
+JSONObject::JSONArray::JSONArray(JSONObject::JSONArray&& other) noexcept : body(other.body)
+{
+    other.body = nullptr;
+}
+
+JSONObject::JSONArray& JSONObject::JSONArray::operator=(const JSONObject::JSONArray& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if (other.body)
+    {
+        ++other.body->ref_count;
+    }
+    Release();
+    body = other.body;
+    return *this;
+}
+
+JSONObject::JSONArray& JSONObject::JSONArray::operator=(JSONObject::JSONArray&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    Release();
+    body = other.body;
+    other.body = nullptr;
+    return *this;
+}
+
+JSONObject::JSONArray::~JSONArray()
+{
+    Release();
+}
+
+void JSONObject::JSONArray::Release()
+{
+    if (body && --body->ref_count == 0)
+    {
+        delete body;
+    }
+    body = nullptr;
+}
+
+JSONObject::JSONArray::Body& JSONObject::JSONArray::Mutable()
+{
+    if (!body)
+    {
+        body = new Body(Storage::GENERIC);
+    }
+    else if (body->ref_count.load() != 1)
+    {
+        Body *copy = new Body(*body);
+        Release();
+        body = copy;
+    }
+
+    body->structural_hash.store(0, std::memory_order_relaxed);
+    delete body->unpacked.exchange(nullptr, std::memory_order_relaxed);
+    return *body;
+}
+
+const JSONObject::JSONArray::ValueArray& JSONObject::JSONArray::Elements() const
+{
+    if (body->storage == Storage::GENERIC)
+    {
+        return body->array;
+    }
+
+    ValueArray *unpacked = body->unpacked.load(std::memory_order_acquire);
+    if (unpacked)
+    {
+        return *unpacked;
+    }
+
+    std::lock_guard<std::mutex> lock(unpack_mutex);
+    unpacked = body->unpacked.load(std::memory_order_relaxed);
+    if (!unpacked)
+    {
+        unpacked = new ValueArray();
+        unpacked->reserve(Size());
+        for (u64 index = 0; index < Size(); ++index)
+        {
+            unpacked->push_back(ValueAt(index));
+        }
+        body->unpacked.store(unpacked, std::memory_order_release);
+    }
+
+    return *unpacked;
+}
+
+void JSONObject::JSONArray::Reserve(u64 capacity)
+{
+    Body& mutable_body = Mutable();
+    switch (mutable_body.storage)
+    {
+        case Storage::GENERIC:
+        {
+            mutable_body.array.reserve(capacity);
+        } break;
+
+        case Storage::INTS:
+        {
+            mutable_body.int_arr.reserve(capacity);
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            mutable_body.double_arr.reserve(capacity);
+        } break;
+
+        case Storage::TABLE:
+        {
+            for (TableColumn& column : mutable_body.columns)
+            {
+                column.values.Reserve(capacity);
+            }
+        } break;
+    }
+}
+
+u64 JSONObject::JSONArray::Hash() const
+{
+    auto compute = [this]()
+    {
+        u64 hash = array_hash_seed;
+        switch (GetStorage())
+        {
+            case Storage::INTS:
+            {
+                for (s32 num : Ints())
+                {
+                    hash = CombineHash(hash, HashOfInt(num));
+                }
+            } break;
+
+            case Storage::DOUBLES:
+            {
+                for (f64 num : Doubles())
+                {
+                    hash = CombineHash(hash, HashOfDouble(num));
+                }
+            } break;
+
+            case Storage::GENERIC:
+            {
+                for (const JSONValue& value : *this)
+                {
+                    hash = CombineHash(hash, value.Hash());
+                }
+            } break;
+
+            // NOTE(19.10.26): a row hashes like the object it stands for
+            case Storage::TABLE:
+            {
+                for (u64 row = 0; row < Size(); ++row)
+                {
+                    u64 row_hash = object_hash_seed;
+                    for (const TableColumn& column : body->columns)
+                    {
+                        row_hash = CombineHash(row_hash, column.hash);
+                        row_hash = CombineHash(row_hash, column.values.ValueAt(row).Hash());
+                    }
+                    hash = CombineHash(hash, row_hash);
+                }
+            } break;
+        }
+
+        return hash;
+    };
+
+    if (!body)
+    {
+        return compute();
+    }
+
+    return CachedHash(body->structural_hash, compute);
+}
+
+void JSONObject::JSONArray::PushBack(s32 value)
+{
+    Body& mutable_body = Mutable();
+    mutable_body.Append(JSONValue(value));
+    Indexes::Inserted(mutable_body, mutable_body.Size() - 1);
+}
+
+void JSONObject::JSONArray::PushBack(f64 value)
+{
+    Body& mutable_body = Mutable();
+    mutable_body.Append(JSONValue(value));
+    Indexes::Inserted(mutable_body, mutable_body.Size() - 1);
+}
+
+void JSONObject::JSONArray::PushBack(JSONValue *value)
+{
+    PushBack(std::move(*value));
+    delete value;
+}
+
+void JSONObject::JSONArray::PushBack(JSONValue&& value)
+{
+    Body& mutable_body = Mutable();
+    mutable_body.Append(std::move(value));
+    Indexes::Inserted(mutable_body, mutable_body.Size() - 1);
+}
+
+void JSONObject::JSONArray::Insert(u64 index, JSONValue&& value)
+{
+    assert(index <= Size());
+
+    Body& mutable_body = Mutable();
+    if (index == mutable_body.Size())
+    {
+        mutable_body.Append(std::move(value));
+    }
+    else if (mutable_body.storage == Storage::INTS && value.type == ValueType::INT)
+    {
+        mutable_body.int_arr.insert(std::next(mutable_body.int_arr.begin(), index), value.int_val);
+    }
+    else if (mutable_body.storage == Storage::DOUBLES && value.type == ValueType::DOUBLE)
+    {
+        mutable_body.double_arr.insert(std::next(mutable_body.double_arr.begin(), index), value.double_val);
+    }
+    else if (mutable_body.storage == Storage::TABLE && mutable_body.Size() && mutable_body.FitsTable(value))
+    {
+        u64 column = 0;
+        for (const Member& member : value.json_val->Read().members)
+        {
+            if (!member.IsRemoved())
+            {
+                mutable_body.columns[column++].values.Insert(index, JSONValue(member.value));
+            }
+        }
+    }
+    else
+    {
+        mutable_body.ToGeneric();
+        mutable_body.array.insert(std::next(mutable_body.array.begin(), index), std::move(value));
+    }
+
+    Indexes::Inserted(mutable_body, index);
+}
+
+JSONObject::JSONValue JSONObject::JSONArray::Erase(u64 index)
+{
+    assert(index < Size());
+
+    Body& mutable_body = Mutable();
+    JSONValue erased;
+    switch (mutable_body.storage)
+    {
+        case Storage::INTS:
+        {
+            erased = JSONValue(mutable_body.int_arr[index]);
+            mutable_body.int_arr.erase(std::next(mutable_body.int_arr.begin(), index));
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            erased = JSONValue(mutable_body.double_arr[index]);
+            mutable_body.double_arr.erase(std::next(mutable_body.double_arr.begin(), index));
+        } break;
+
+        case Storage::TABLE:
+        {
+            erased = ValueAt(index);
+            for (TableColumn& column : mutable_body.columns)
+            {
+                column.values.Erase(index);
+            }
+        } break;
+
+        case Storage::GENERIC:
+        {
+            erased = std::move(mutable_body.array[index]);
+            mutable_body.array.erase(std::next(mutable_body.array.begin(), index));
+        } break;
+    }
+
+    Indexes::Erased(mutable_body, index, erased);
+    return erased;
+}
+
+u64 JSONObject::JSONArray::EraseIndices(Span<const u64> indices)
+{
+    u64 size = Size();
+    if (indices.Size() == 0 || size == 0)
+    {
+        return 0;
+    }
+
+    // NOTE(19.10.26): the removal pass wants ascending, unique and in range indices. 
+    // other input is sorted and cleaned into a copy first
+    b8 is_clean = indices[indices.Size() - 1] < size;
+    for (u64 at = 1; at < indices.Size() && is_clean; ++at)
+    {
+        is_clean = indices[at - 1] < indices[at];
+    }
+
+    std::vector<u64> cleaned;
+    if (!is_clean)
+    {
+        cleaned.assign(indices.begin(), indices.end());
+        std::sort(cleaned.begin(), cleaned.end());
+        cleaned.erase(std::unique(cleaned.begin(), cleaned.end()), cleaned.end());
+        cleaned.erase(std::lower_bound(cleaned.begin(), cleaned.end(), size), cleaned.end());
+        if (cleaned.empty())
+        {
+            return 0;
+        }
+        indices = Span<const u64>(cleaned.data(), cleaned.size());
+    }
+
+    Body& mutable_body = Mutable();
+    u64 next = 0;
+    auto removes = [&indices, &next](u64 index, const auto&)
+    {
+        if (next < indices.Size() && indices[next] == index)
+        {
+            ++next;
+            return true;
+        }
+
+        return false;
+    };
+
+    u64 num_removed = 0;
+    switch (mutable_body.storage)
+    {
+        case Storage::INTS:
+        {
+            num_removed = Compact(mutable_body.int_arr, removes);
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            num_removed = Compact(mutable_body.double_arr, removes);
+        } break;
+
+        case Storage::GENERIC:
+        {
+            num_removed = Compact(mutable_body.array, removes);
+        } break;
+
+        case Storage::TABLE:
+        {
+            for (TableColumn& column : mutable_body.columns)
+            {
+                num_removed = column.values.EraseIndices(indices);
+            }
+        } break;
+    }
+
+    Indexes::MarkStale(mutable_body);
+    return num_removed;
+}
+
+void JSONObject::JSONArray::MarkIndexesStale(Body& body)
+{
+    Indexes::MarkStale(body);
+}
+
+JSONObject::JSONValue& JSONObject::JSONArray::At(u64 index)
+{
+    assert(index < Size());
+    
+    Body& mutable_body = Mutable();
+    mutable_body.ToGeneric();
+    Indexes::MarkStale(mutable_body);
+    return mutable_body.array[index];
+}
+
+const JSONObject::JSONValue& JSONObject::JSONArray::At(u64 index) const
+{
+    assert(index < Size());
+    
+    return Elements()[index];
+}
+
+JSONObject::JSONValue JSONObject::JSONArray::ValueAt(u64 index) const
+{
+    assert(index < Size());
+
+    switch (body->storage)
+    {
+        case Storage::INTS:
+        {
+            return JSONValue(body->int_arr[index]);
+        } break;
+
+        case Storage::DOUBLES:
+        {
+            return JSONValue(body->double_arr[index]);
+        } break;
+
+        case Storage::TABLE:
+        {
+            return JSONValue(Row(index).Materialize());
+        } break;
+
+        case Storage::GENERIC:
+        default:
+        {
+            return body->array[index];
+        } break;
+    }
+}
+
+u64 JSONObject::JSONArray::Size() const
 {
-    return is_const ? **m_const_iter : **m_iter;
+    return body ? body->Size() : 0;
 }
 
-JSONObject::JSONArray::Iterator& JSONObject::JSONArray::Iterator::operator++() 
+JSONObject::JSONArray::Storage JSONObject::JSONArray::GetStorage() const
 {
-    is_const ? ++m_const_iter : ++m_iter;
-    
-    return *this;
+    return body ? body->storage : Storage::GENERIC;
 }
 
-JSONObject::JSONArray::Iterator JSONObject::JSONArray::Iterator::operator++(int) 
+Span<const s32> JSONObject::JSONArray::Ints() const
 {
-    Iterator temp = *this;
-    ++(*this);
-    return temp;
-}                
+    if (GetStorage() != Storage::INTS)
+    {
+        return Span<const s32>();
+    }
 
-bool JSONObject::JSONArray::Iterator::operator==(const Iterator& other) const 
-{ 
-    if (is_const != other.is_const) return 0;
-    bool comp_const = m_const_iter == other.m_const_iter;
-    bool comp = m_iter == other.m_iter;
-    return is_const ? m_const_iter == other.m_const_iter : m_iter == other.m_iter;
+    return Span<const s32>(body->int_arr.data(), body->int_arr.size());
 }
 
-bool JSONObject::JSONArray::Iterator::operator!=(const Iterator& other) const 
-{ 
-    return !(*this == other);
+Span<s32> JSONObject::JSONArray::Ints()
+{
+    if (GetStorage() != Storage::INTS)
+    {
+        return Span<s32>();
+    }
+
+    Body& mutable_body = Mutable();
+    return Span<s32>(mutable_body.int_arr.data(), mutable_body.int_arr.size());
 }
 
-/**************************************************************************************************
- * 
- *  JSONArray
- * 
- **************************************************************************************************/
+Span<const f64> JSONObject::JSONArray::Doubles() const
+{
+    if (GetStorage() != Storage::DOUBLES)
+    {
+        return Span<const f64>();
+    }
+
+    return Span<const f64>(body->double_arr.data(), body->double_arr.size());
+}
 
-JSONObject::JSONArray::JSONArray(const JSONObject::JSONArray& other)
+Span<f64> JSONObject::JSONArray::Doubles()
 {
-    array.assign(other.array.begin(), other.array.end());
+    if (GetStorage() != Storage::DOUBLES)
+    {
+        return Span<f64>();
+    }
+
+    Body& mutable_body = Mutable();
+    return Span<f64>(mutable_body.double_arr.data(), mutable_body.double_arr.size());
 }
 
-JSONObject::JSONArray& JSONObject::JSONArray::operator=(const JSONObject::JSONArray& other)
+Span<const JSONObject::JSONArray::TableColumn> JSONObject::JSONArray::Columns() const
 {
-    array.assign(other.array.begin(), other.array.end());
-    return *this;
+    if (GetStorage() != Storage::TABLE)
+    {
+        return Span<const TableColumn>();
+    }
+
+    return Span<const TableColumn>(body->columns.data(), body->columns.size());
 }
 
-JSONObject::JSONArray::~JSONArray()
+const JSONObject::JSONArray* JSONObject::JSONArray::Column(std::string_view key) const
 {
-    array.clear();
+    return Column(Key(key));
 }
 
-void JSONObject::JSONArray::PushBack(JSONValue *value)
+const JSONObject::JSONArray* JSONObject::JSONArray::Column(const Key& key) const
 {
-    array.push_back(value);
+    for (const TableColumn& column : Columns())
+    {
+        if (column.hash == key.Hash() && column.key == key.View())
+        {
+            return &column.values;
+        }
+    }
+
+    return nullptr;
 }
 
-JSONObject::JSONValue JSONObject::JSONArray::Erase(u64 index)
+JSONObject::JSONArray::RowView JSONObject::JSONArray::Row(u64 index) const
 {
-    assert(index < array.size());
+    assert(index < Size());
 
-    auto iter = array.erase(std::next(array.begin(), index));
-    return **iter;
+    return RowView(GetStorage() == Storage::TABLE ? &body->columns : nullptr, index);
 }
 
-JSONObject::JSONValue& JSONObject::JSONArray::At(u64 index) const
+template<typename T>
+b8 JSONObject::JSONArray::ExtractColumn(const Key& key, Span<T> out) const
 {
-    assert(index < array.size());
-    
-    return *array[index];
+    return ExtractColumns(Span<const Key>(&key, 1), Span<const Span<T>>(&out, 1));
 }
 
-u64 JSONObject::JSONArray::Size() const
+template<typename T>
+b8 JSONObject::JSONArray::ExtractColumns(Span<const Key> keys, Span<const Span<T>> outs) const
+{
+    assert(keys.Size() == outs.Size());
+
+    u64 size = Size();
+    switch (GetStorage())
+    {
+        case Storage::TABLE:
+        {
+            b8 complete = 1;
+            for (u64 field = 0; field < keys.Size(); ++field)
+            {
+                const JSONArray *column = Column(keys[field]);
+                if (!column)
+                {
+                    std::fill_n(outs[field].Data(), size, T());
+                    complete = 0;
+                    continue;
+                }
+
+                complete &= CopyColumn(*column, outs[field]);
+            }
+            return complete;
+        }
+
+        case Storage::INTS:
+        case Storage::DOUBLES:
+        {
+            for (const Span<T>& out : outs)
+            {
+                std::fill_n(out.Data(), size, T());
+            }
+            return size == 0;
+        }
+
+        case Storage::GENERIC:
+        {
+        } break;
+    }
+
+    // NOTE(19.10.26): the slot each key was last found in, elements built the same way
+    // keep their keys in the same slots. the slots live on the stack, more keys than fit 
+    // are extracted in another pass over the elements
+    const u64 slots_max = 16;
+    u64 slots[slots_max];
+    b8 complete = 1;
+    for (u64 first = 0; first < keys.Size(); first += slots_max)
+    {
+        u64 num_fields = std::min(slots_max, keys.Size() - first);
+        std::fill_n(slots, num_fields, 0);
+        for (u64 index = 0; index < size; ++index)
+        {
+            const JSONValue& element = body->array[index];
+            if (element.type != ValueType::JSON_OBJECT)
+            {
+                for (u64 field = first; field < first + num_fields; ++field)
+                {
+                    outs[field][index] = T();
+                }
+                complete = 0;
+                continue;
+            }
+
+            const std::vector<Member>& members = element.json_val->Read().members;
+            for (u64 field = 0; field < num_fields; ++field)
+            {
+                const Key& key = keys[first + field];
+                const Span<T>& out = outs[first + field];
+                u64 slot = slots[field];
+                if (slot >= members.size() || members[slot].hash != key.Hash() || 
+                    members[slot].key != key.View() || members[slot].IsRemoved())
+                {
+                    s64 found = element.json_val->Read().Find(key.View(), key.Hash());
+                    if (found < 0)
+                    {
+                        out[index] = T();
+                        complete = 0;
+                        continue;
+                    }
+
+                    slot = found;
+                    slots[field] = slot;
+                }
+
+                complete &= NumberOf(members[slot].value, out[index]);
+            }
+        }
+    }
+
+    return complete;
+}
+
+template b8 JSONObject::JSONArray::ExtractColumn<s32>(const Key& key, Span<s32> out) const;
+template b8 JSONObject::JSONArray::ExtractColumn<f64>(const Key& key, Span<f64> out) const;
+template b8 JSONObject::JSONArray::ExtractColumns<s32>(Span<const Key> keys, Span<const Span<s32>> outs) const;
+template b8 JSONObject::JSONArray::ExtractColumns<f64>(Span<const Key> keys, Span<const Span<f64>> outs) const;
+
+b8 JSONObject::JSONArray::ToTable()
+{
+    Storage storage = GetStorage();
+    if (storage == Storage::TABLE)
+    {
+        return 1;
+    }
+
+    if (storage != Storage::GENERIC)
+    {
+        return 0;
+    }
+
+    Body *table = new Body(Storage::TABLE);
+    if (body)
+    {
+        for (const JSONValue& value : body->array)
+        {
+            if (!table->FitsTable(value))
+            {
+                delete table;
+                return 0;
+            }
+
+            table->Append(JSONValue(value));
+        }
+
+        // NOTE(19.10.26): the rows keep their positions, the indexes stay valid
+        if (body->indexes)
+        {
+            table->indexes.reset(new Indexes(*body->indexes));
+        }
+    }
+
+    Release();
+    body = table;
+    return 1;
+}
+
+JSONObject::JSONArray::IndexStats JSONObject::JSONArray::BuildIndex(std::string_view key)
+{
+    Body& mutable_body = Mutable();
+    if (!mutable_body.indexes)
+    {
+        mutable_body.indexes.reset(new Indexes());
+    }
+
+    Indexes& indexes = *mutable_body.indexes;
+    indexes.Refresh(mutable_body);
+
+    Key field_key(key);
+    Indexes::Field *field = indexes.FieldFor(field_key);
+    if (!field)
+    {
+        indexes.fields.push_back(Indexes::Field{std::string(key), field_key.Hash(), {}, 0, 0});
+        field = &indexes.fields.back();
+    }
+
+    indexes.Build(*field, mutable_body);
+    return Indexes::StatsOf(*field);
+}
+
+b8 JSONObject::JSONArray::DropIndex(std::string_view key)
+{
+    if (!body || !body->indexes)
+    {
+        return 0;
+    }
+
+    Body& mutable_body = Mutable();
+    std::vector<Indexes::Field>& fields = mutable_body.indexes->fields;
+    Key field_key(key);
+    for (u64 index = 0; index < fields.size(); ++index)
+    {
+        if (fields[index].hash == field_key.Hash() && fields[index].key == key)
+        {
+            fields.erase(std::next(fields.begin(), index));
+            if (fields.empty())
+            {
+                mutable_body.indexes.reset();
+            }
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+JSONObject::JSONArray::IndexStats JSONObject::JSONArray::GetIndexStats(std::string_view key) const
+{
+    Indexes *indexes = body ? body->indexes.get() : nullptr;
+    Indexes::Field *field = indexes ? indexes->FieldFor(Key(key)) : nullptr;
+    if (!field)
+    {
+        return IndexStats{0, 0, 0};
+    }
+
+    indexes->Refresh(*body);
+    return Indexes::StatsOf(*field);
+}
+
+s64 JSONObject::JSONArray::Find(const Key& key, const JSONValue& value) const
 {
-    return array.size();
+    if (!body)
+    {
+        return -1;
+    }
+
+    Indexes *indexes = body->indexes.get();
+    Indexes::Field *field = indexes ? indexes->FieldFor(key) : nullptr;
+    if (field)
+    {
+        indexes->Refresh(*body);
+        return Indexes::Find(*field, *body, key, value);
+    }
+
+    JSONValue scratch;
+    for (u64 position = 0; position < body->Size(); ++position)
+    {
+        const JSONValue *at = Indexes::FieldAt(*body, position, key, scratch);
+        if (at && *at == value)
+        {
+            return position;
+        }
+    }
+
+    return -1;
 }
 
-JSONObject::JSONArray::Iterator JSONObject::JSONArray::begin() const
+JSONObject::JSONArray::ConstIterator JSONObject::JSONArray::begin() const
 {
-    return Iterator(array.begin());
+    if (!body)
+    {
+        return ConstIterator(nullptr);
+    }
+
+    return ConstIterator(Elements().data());
 }
 
-JSONObject::JSONArray::Iterator JSONObject::JSONArray::end() const
+JSONObject::JSONArray::ConstIterator JSONObject::JSONArray::end() const
 {
-    return Iterator(array.end());
+    if (!body)
+    {
+        return ConstIterator(nullptr);
+    }
+
+    const ValueArray& elements = Elements();
+    return ConstIterator(elements.data() + elements.size());
 }
 
 JSONObject::JSONArray::Iterator JSONObject::JSONArray::begin()
 {
-    return Iterator(array.begin());
+    if (!body)
+    {
+        return Iterator(nullptr);
+    }
+
+    Body& mutable_body = Mutable();
+    mutable_body.ToGeneric();
+    Indexes::MarkStale(mutable_body);
+    return Iterator(mutable_body.array.data());
 }
 
 JSONObject::JSONArray::Iterator JSONObject::JSONArray::end()
 {
-    return Iterator(array.end());
+    if (!body)
+    {
+        return Iterator(nullptr);
+    }
+
+    Body& mutable_body = Mutable();
+    mutable_body.ToGeneric();
+    Indexes::MarkStale(mutable_body);
+    return Iterator(mutable_body.array.data() + mutable_body.array.size());
+}
+
+/**************************************************************************************************
+ * 
+ *  JSONArray::RowView
+ * 
+ **************************************************************************************************/
+
+JSONObject::JSONValue JSONObject::JSONArray::RowView::operator[](std::string_view key) const
+{
+    return (*this)[Key(key)];
+}
+
+JSONObject::JSONValue JSONObject::JSONArray::RowView::operator[](const Key& key) const
+{
+    if (columns)
+    {
+        for (const TableColumn& column : *columns)
+        {
+            if (column.hash == key.Hash() && column.key == key.View())
+            {
+                return column.values.ValueAt(row);
+            }
+        }
+    }
+
+    return JSONValue(ValueType::BAD_TYPE);
+}
+
+u64 JSONObject::JSONArray::RowView::Size() const
+{
+    return columns ? columns->size() : 0;
+}
+
+JSONObject JSONObject::JSONArray::RowView::Materialize() const
+{
+    JSONObject obj;
+    if (!columns || columns->empty())
+    {
+        return obj;
+    }
+
+    // NOTE(19.10.26): the column keys are distinct, the members are appended without a lookup
+    JSONObject::Body& obj_body = obj.Mutable();
+    obj_body.members.reserve(columns->size());
+    for (const TableColumn& column : *columns)
+    {
+        obj_body.members.emplace_back(std::string(column.key), column.hash, column.values.ValueAt(row));
+        obj_body.IndexLast();
+    }
+
+    return obj;
 }
 
 /**************************************************************************************************
@@ -133,6 +1623,45 @@ JSONObject::JSONValue::JSONValue(const JSONValue &value)
     AssignValueByType(value);
 }
 
+JSONObject::JSONValue::JSONValue(JSONValue &&value) noexcept : type(value.type)
+{
+    switch (value.type)
+    {
+        case JSONObject::ValueType::INT:
+        {
+            int_val = value.int_val;
+        } break;
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            double_val = value.double_val;
+        } break;
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            new (&str_val) std::string(std::move(value.str_val));
+        } break;
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            json_val = value.json_val;
+            value.type = ValueType::NULL_TYPE;
+        } break;
+
+        case JSONObject::ValueType::ARR:
+        {
+            new (&json_arr) JSONArray(std::move(value.json_arr));
+        } break;
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+}
+
 JSONObject::JSONValue::JSONValue(const JSONObject &value) : type(ValueType::JSON_OBJECT)
 {
     json_val = new JSONObject(value);
@@ -143,14 +1672,37 @@ JSONObject::JSONValue::JSONValue(const JSONObject *value) : type(ValueType::JSON
     json_val = new JSONObject(*value);
 }
 
-JSONObject::JSONValue& JSONObject::JSONValue::operator=(const JSONValue& other)
+JSONObject::JSONValue::JSONValue(JSONObject &&value) : type(ValueType::JSON_OBJECT)
+{
+    json_val = new JSONObject(std::move(value));
+}
+
+JSONObject::JSONValue& JSONObject::JSONValue::operator=(const JSONValue& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    
+    // NOTE(19.10.26): other may be owned by this value (e.g. value = value["nested"]),
+    // so it is copied before the old value is destroyed
+    JSONValue copy(other);
+    this->~JSONValue();
+    new (this) JSONValue(std::move(copy));
+    return *this;
+}
+
+JSONObject::JSONValue& JSONObject::JSONValue::operator=(JSONValue&& other) noexcept
 {
     if (this == &other)
     {
         return *this;
     }
     
-    AssignValueByType(other);
+    // NOTE(19.10.26): same as the copy assignment, other may be owned by this value
+    JSONValue moved(std::move(other));
+    this->~JSONValue();
+    new (this) JSONValue(std::move(moved));
     return *this;
 }
 
@@ -234,83 +1786,99 @@ JSONObject::JSONValue JSONObject::JSONValue::operator[](u64 index)
 
         case JSONObject::ValueType::ARR:
         {
-            return json_arr.At(index);
+            return json_arr.ValueAt(index);
         } break;
     }
 }
 
-JSONObject::JSONValue& JSONObject::JSONValue::operator[](std::string key)
+JSONObject::JSONValue& JSONObject::JSONValue::operator[](std::string_view key)
+{
+    if (type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        return (*json_val)[key];
+    }
+
+    return const_cast<JSONValue&>(JSONObject::bad_value);
+}
+
+JSONObject::JSONValue& JSONObject::JSONValue::operator[](const char* key)
 {
-    const JSONValue& val = static_cast<const JSONValue&>(*this)[key];
-    return const_cast<JSONValue&>(val);
+    return (*this)[std::string_view(key)];
 }
 
-const JSONObject::JSONValue& JSONObject::JSONValue::operator[](std::string key) const
+JSONObject::JSONValue& JSONObject::JSONValue::operator[](const Key& key)
 {
     if (type == JSONObject::ValueType::JSON_OBJECT)
     {
         return (*json_val)[key];
     }
 
-    return JSONObject::bad_value;
+    return const_cast<JSONValue&>(JSONObject::bad_value);
 }
 
-JSONObject::JSONValue& JSONObject::JSONValue::operator[](const char* key)
+const JSONObject::JSONValue& JSONObject::JSONValue::operator[](std::string_view key) const
 {
-    return (*this)[std::string(key)];
+    if (type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        return static_cast<const JSONObject&>(*json_val)[key];
+    }
+
+    return JSONObject::bad_value;
 }
 
 const JSONObject::JSONValue& JSONObject::JSONValue::operator[](const char* key) const
 {
-    return (*this)[std::string(key)];
+    return (*this)[std::string_view(key)];
 }
 
-void JSONObject::JSONValue::PrintValueByType(u8 indent, std::ostream& out) const
+const JSONObject::JSONValue& JSONObject::JSONValue::operator[](const Key& key) const
 {
-        switch (type)
-        {
-            case JSONObject::ValueType::BAD_TYPE:
-            case JSONObject::ValueType::NULL_TYPE:
-            {
-            } break;
+    if (type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        return static_cast<const JSONObject&>(*json_val)[key];
+    }
 
-            case JSONObject::ValueType::INT:
-            {
-                out << int_val << "\n";
-            } break;
+    return JSONObject::bad_value;
+}
 
-            case JSONObject::ValueType::DOUBLE:
-            {
-                out << double_val << "\n";
-            } break;
+u64 JSONObject::JSONValue::Hash() const
+{
+    switch (type)
+    {
+        case JSONObject::ValueType::INT:
+        {
+            return HashOfInt(int_val);
+        }
 
-            case JSONObject::ValueType::STR:
-            {
-                out << "\"" << str_val << "\"" << "\n";
-            } break;
+        case JSONObject::ValueType::DOUBLE:
+        {
+            return HashOfDouble(double_val);
+        }
 
-            case JSONObject::ValueType::JSON_OBJECT:
-            {
-                out << "{\n";
-                json_val->RecPrint(indent + 1, out);
-                out << std::string(indent, '\t') << "}\n";
-            } break;
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            return CombineHash((u64)type, HashKey(str_val));
+        }
 
-            case JSONObject::ValueType::ARR:
-            {
-                out << "[";
-                for (u64 index = 0; index < json_arr.Size() ; ++index)
-                {
-                    out << json_arr.At(index) << 
-                           (index == json_arr.Size() - 1 ? "]" : ",");
-                }
-                out << "\n";
-            } break;
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            return json_val->Hash();
+        }
 
-            case JSONObject::ValueType::NUM_JSON_TYPES:
-            {
-            } break;
+        case JSONObject::ValueType::ARR:
+        {
+            return json_arr.Hash();
         }
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+
+    return CombineHash((u64)type, 0);
 }
 
 void JSONObject::JSONValue::AssignValueByType(const JSONValue& src)
@@ -329,9 +1897,10 @@ void JSONObject::JSONValue::AssignValueByType(const JSONValue& src)
             double_val = src.double_val;
         } break;
 
+        case JSONObject::ValueType::KEY:
         case JSONObject::ValueType::STR:
         {
-            type = ValueType::STR;
+            type = src.type;
             new (&str_val) std::string(src.str_val);
         } break;
 
@@ -355,6 +1924,7 @@ void JSONObject::JSONValue::AssignValueByType(const JSONValue& src)
         
         case JSONObject::ValueType::BAD_TYPE:
         {
+            type = ValueType::BAD_TYPE;
         } break;
     }
 }
@@ -372,6 +1942,7 @@ JSONObject::JSONValue::~JSONValue()
             type = ValueType::NULL_TYPE;
         } break;
 
+        case ValueType::KEY:
         case ValueType::STR:
         {
             str_val.~basic_string();
@@ -399,15 +1970,21 @@ JSONObject::JSONValue::~JSONValue()
  * 
  **************************************************************************************************/
 
-JSONObject::JSONObject(const JSONObject& other) : insertion_order(other.insertion_order)
+const JSONObject::Body JSONObject::empty_body;
+
+JSONObject::JSONObject(const JSONObject& other) : body(other.body)
 {
-    for (auto& pair : other.json)
+    if (body)
     {
-        JSONValue *copy_value = new JSONValue(*(pair.second));
-        json.insert({pair.first, copy_value});
+        ++body->ref_count;
     }
 }
 
+JSONObject::JSONObject(JSONObject&& other) noexcept : body(other.body)
+{
+    other.body = nullptr;
+}
+
 JSONObject& JSONObject::operator=(const JSONObject& other)
 {
     if (this == &other)
@@ -415,10 +1992,26 @@ JSONObject& JSONObject::operator=(const JSONObject& other)
         return *this;
     }
     
-    json.clear();
-    json.insert(other.json.begin(), other.json.end());
-   
-    insertion_order.assign(other.insertion_order.begin(), other.insertion_order.end());
+    if (other.body)
+    {
+        ++other.body->ref_count;
+    }
+    Release();
+    body = other.body;
+
+    return *this;
+}
+
+JSONObject& JSONObject::operator=(JSONObject&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    
+    Release();
+    body = other.body;
+    other.body = nullptr;
 
     return *this;
 }
@@ -427,58 +2020,351 @@ JSONObject::~JSONObject()
 {
     // Profiler_TimeFunction; // NOTE(28.10.24): PROFILING
 
-    for (auto& pair : json)
+    Release();
+}
+
+void JSONObject::Release()
+{
+    if (body && --body->ref_count == 0)
+    {
+        delete body;
+    }
+    body = nullptr;
+}
+
+u64 JSONObject::Hash() const
+{
+    auto compute = [this]()
+    {
+        u64 hash = object_hash_seed;
+        for (const Member& member : Read().members)
+        {
+            if (member.IsRemoved())
+            {
+                continue;
+            }
+
+            hash = CombineHash(hash, member.hash);
+            hash = CombineHash(hash, member.value.Hash());
+        }
+
+        return hash;
+    };
+
+    if (!body)
     {
-        delete pair.second;
+        return compute();
     }
-    json.clear();
-    insertion_order.clear();
+
+    return CachedHash(body->structural_hash, compute);
 }
 
-void JSONObject::Put(const std::string key, JSONValue *value)
+JSONObject::Body& JSONObject::Mutable()
 {
-    auto res = json.insert({key, value});
-    if (res.second)
+    if (!body)
+    {
+        body = new Body();
+    }
+    else if (body->ref_count.load() != 1)
     {
-        insertion_order.push_back(key);
+        Body *copy = new Body(*body);
+        Release();
+        body = copy;
     }
+
+    body->structural_hash.store(0, std::memory_order_relaxed);
+    return *body;
+}
+
+void JSONObject::Put(std::string&& key, JSONValue&& value)
+{
+    Emplace(std::move(key), std::move(value));
+}
+
+void JSONObject::Put(const std::string& key, JSONValue *value)
+{
+    Emplace(key, std::move(*value));
+    delete value;
 }
 
 JSONObject& JSONObject::AddObj(const std::string &key)
 {
-    JSONObject *new_obj = new JSONObject();
-    return *new_obj;
+    return Emplace(key, JSONObject());
 }   
 
-void JSONObject::Remove(std::string key)
+b8 JSONObject::Remove(std::string_view key)
+{
+    if (!body)
+    {
+        return 0;
+    }
+
+    s64 slot = body->Find(key, HashKey(key));
+    if (slot < 0)
+    {
+        return 0;
+    }
+
+    // NOTE(19.10.26): a detached copy keeps the slots of the shared body, slot stays valid
+    Body& mutable_body = Mutable();
+    Member& member = mutable_body.members[slot];
+    member.value = JSONValue();
+    member.removed = 1;
+    std::string().swap(member.key);
+    ++mutable_body.num_removed;
+
+    if (mutable_body.num_removed > mutable_body.Size())
+    {
+        mutable_body.Compact();
+    }
+
+    return 1;
+}
+
+u64 JSONObject::Size() const
 {
-    // TODO(28.07.24): impl
+    return Read().Size();
 }
 
-JSONObject::JSONValue& JSONObject::operator[](std::string key)
+JSONObject::ConstIterator JSONObject::begin() const
 {
-    return const_cast<JSONValue&>(static_cast<const JSONObject&>(*this)[key]);
+    const Body& read_body = Read();
+    return ConstIterator(read_body.members.data(), read_body.members.data() + read_body.members.size());
 }
 
-const JSONObject::JSONValue& JSONObject::operator[](std::string key) const
+JSONObject::ConstIterator JSONObject::end() const
 {
-    
-    auto value = json.find(key);
-    if (value == json.end())
+    const Body& read_body = Read();
+    const Member *stop = read_body.members.data() + read_body.members.size();
+    return ConstIterator(stop, stop);
+}
+
+JSONObject::Iterator JSONObject::begin()
+{
+    if (!body)
+    {
+        return Iterator(nullptr, nullptr);
+    }
+
+    Body& mutable_body = Mutable();
+    return Iterator(mutable_body.members.data(), mutable_body.members.data() + mutable_body.members.size());
+}
+
+JSONObject::Iterator JSONObject::end()
+{
+    if (!body)
+    {
+        return Iterator(nullptr, nullptr);
+    }
+
+    Body& mutable_body = Mutable();
+    Member *stop = mutable_body.members.data() + mutable_body.members.size();
+    return Iterator(stop, stop);
+}
+
+JSONObject::JSONValue& JSONObject::operator[](std::string_view key)
+{
+    return Lookup(key, HashKey(key));
+}
+
+JSONObject::JSONValue& JSONObject::operator[](const Key& key)
+{
+    return Lookup(key.View(), key.Hash());
+}
+
+const JSONObject::JSONValue& JSONObject::operator[](std::string_view key) const
+{
+    return Lookup(key, HashKey(key));
+}
+
+const JSONObject::JSONValue& JSONObject::operator[](const Key& key) const
+{
+    return Lookup(key.View(), key.Hash());
+}
+
+JSONObject::JSONValue& JSONObject::Lookup(std::string_view key, u64 hash)
+{
+    if (!body)
+    {
+        return const_cast<JSONValue&>(bad_value);
+    }
+
+    s64 slot = body->Find(key, hash);
+    if (slot < 0)
+    {
+        return const_cast<JSONValue&>(bad_value);
+    }
+    return Mutable().members[slot].value;
+}
+
+const JSONObject::JSONValue& JSONObject::Lookup(std::string_view key, u64 hash) const
+{
+    const Body& read_body = Read();
+    s64 slot = read_body.Find(key, hash);
+    if (slot < 0)
     {
         return bad_value;
     }
-    return *(value->second);
+    return read_body.members[slot].value;
+}
+
+s64 JSONObject::Body::Find(std::string_view key, u64 hash) const
+{
+    if (index.empty())
+    {
+        for (u64 slot = 0; slot < members.size(); ++slot)
+        {
+            if (members[slot].hash == hash && members[slot].key == key && !members[slot].IsRemoved())
+            {
+                return slot;
+            }
+        }
+
+        return -1;
+    }
+
+    u64 mask = index.size() - 1;
+    for (u64 at = hash & mask; ; at = (at + 1) & mask)
+    {
+        u32 entry = index[at];
+        if (entry == 0)
+        {
+            return -1;
+        }
+
+        const Member& member = members[entry - 1];
+        if (member.hash == hash && member.key == key && !member.IsRemoved())
+        {
+            return entry - 1;
+        }
+    }
+}
+
+void JSONObject::Body::IndexLast()
+{
+    if (members.size() <= linear_lookup_max)
+    {
+        return;
+    }
+
+    if (index.empty() || members.size() * 4 > index.size() * 3)
+    {
+        Reindex();
+        return;
+    }
+
+    u64 mask = index.size() - 1;
+    u64 at = members.back().hash & mask;
+    while (index[at] != 0)
+    {
+        at = (at + 1) & mask;
+    }
+    index[at] = members.size();
+}
+
+void JSONObject::Body::Reindex()
+{
+    u64 capacity = 16;
+    while (capacity < members.size() * 2)
+    {
+        capacity *= 2;
+    }
+
+    index.assign(capacity, 0);
+    
+    u64 mask = capacity - 1;
+    for (u64 slot = 0; slot < members.size(); ++slot)
+    {
+        u64 at = members[slot].hash & mask;
+        while (index[at] != 0)
+        {
+            at = (at + 1) & mask;
+        }
+        index[at] = slot + 1;
+    }
+}
+
+void JSONObject::Body::Compact()
+{
+    members.erase(std::remove_if(members.begin(), members.end(),
+                                 [](const Member& member) { return member.IsRemoved(); }),
+                  members.end());
+    num_removed = 0;
+
+    if (members.size() <= linear_lookup_max)
+    {
+        index.clear();
+    }
+    else
+    {
+        Reindex();
+    }
 }
 
 bool operator==(const JSONObject::JSONArray& lhs, const JSONObject::JSONArray& rhs)
 {
-    if (&lhs == &rhs)
+    if (&lhs == &rhs || lhs.body == rhs.body)
     {
         return 1;
     }
+
+    // NOTE(19.10.26): most unequal arrays differ in size or hash, the walk below only
+    // runs to confirm equal hashes
+    if (lhs.Size() != rhs.Size() || lhs.Hash() != rhs.Hash())
+    {
+        return 0;
+    }
+
+    JSONArray::Storage lhs_storage = lhs.GetStorage();
+    JSONArray::Storage rhs_storage = rhs.GetStorage();
+    if (lhs_storage != JSONArray::Storage::GENERIC || rhs_storage != JSONArray::Storage::GENERIC)
+    {
+        if (lhs_storage == JSONArray::Storage::INTS && rhs_storage == JSONArray::Storage::INTS)
+        {
+            return lhs.body->int_arr == rhs.body->int_arr;
+        }
+
+        if (lhs_storage == JSONArray::Storage::DOUBLES && rhs_storage == JSONArray::Storage::DOUBLES)
+        {
+            return lhs.body->double_arr == rhs.body->double_arr;
+        }
+
+        // NOTE(19.10.26): tables with the same keys compare column by column
+        if (lhs_storage == JSONArray::Storage::TABLE && rhs_storage == JSONArray::Storage::TABLE &&
+            lhs.body->columns.size() == rhs.body->columns.size())
+        {
+            b8 same_keys = 1;
+            for (u64 column = 0; column < lhs.body->columns.size() && same_keys; ++column)
+            {
+                same_keys = lhs.body->columns[column].key == rhs.body->columns[column].key;
+            }
+
+            if (same_keys)
+            {
+                for (u64 column = 0; column < lhs.body->columns.size(); ++column)
+                {
+                    if (lhs.body->columns[column].values != rhs.body->columns[column].values)
+                    {
+                        return 0;
+                    }
+                }
+
+                return 1;
+            }
+        }
+
+        for (u64 index = 0; index < lhs.Size() && index < rhs.Size(); ++index)
+        {
+            if (lhs.ValueAt(index) != rhs.ValueAt(index))
+            {
+                return 0;
+            }
+        }
+
+        return 1;
+    }
     
-    for (JSONArray::Iterator lhs_iter = lhs.begin(), rhs_iter = rhs.begin();
+    for (JSONArray::ConstIterator lhs_iter = lhs.begin(), rhs_iter = rhs.begin();
          lhs_iter != lhs.end() && rhs_iter != rhs.end();
          ++lhs_iter, ++rhs_iter)
     {
@@ -499,27 +2385,46 @@ bool operator!=(const JSONObject::JSONArray& lhs, const JSONObject::JSONArray& r
 
 bool operator==(const JSONObject& lhs, const JSONObject& rhs)
 {
-    if (&lhs == &rhs)
+    if (&lhs == &rhs || lhs.body == rhs.body)
     {
         return 1;
     }
+
+    const JSONObject::Body& lhs_body = lhs.Read();
+    const JSONObject::Body& rhs_body = rhs.Read();
     
-    if (lhs.json.size() != rhs.json.size() ||
-        lhs.insertion_order.size() != rhs.insertion_order.size())
+    if (lhs_body.Size() != rhs_body.Size() || lhs.Hash() != rhs.Hash())
     {
         return 0;
     }
 
-    for (auto lhs_iter = lhs.insertion_order.begin(), rhs_iter = rhs.insertion_order.begin();
-         lhs_iter != lhs.insertion_order.end() && rhs_iter != rhs.insertion_order.end();
-         ++lhs_iter, ++rhs_iter)
+    // NOTE(19.10.26): the live members are paired in order, tombstones may sit in
+    // different slots on the two sides
+    u64 lhs_slot = 0;
+    u64 rhs_slot = 0;
+    for (u64 count = 0; count < lhs_body.Size(); ++count, ++lhs_slot, ++rhs_slot)
     {
-        if (*lhs_iter != *rhs_iter)
+        while (lhs_slot < lhs_body.members.size() && lhs_body.members[lhs_slot].IsRemoved())
+        {
+            ++lhs_slot;
+        }
+        while (rhs_slot < rhs_body.members.size() && rhs_body.members[rhs_slot].IsRemoved())
+        {
+            ++rhs_slot;
+        }
+        if (lhs_slot == lhs_body.members.size() || rhs_slot == rhs_body.members.size())
+        {
+            return 0;
+        }
+
+        const JSONObject::Member& lhs_member = lhs_body.members[lhs_slot];
+        const JSONObject::Member& rhs_member = rhs_body.members[rhs_slot];
+        if (lhs_member.hash != rhs_member.hash || lhs_member.key != rhs_member.key)
         {
             return 0;
         }
 
-        if (*(lhs.json.at(*lhs_iter)) != *(rhs.json.at(*rhs_iter)))
+        if (lhs_member.value != rhs_member.value)
         {
             return 0;
         }
@@ -563,6 +2468,7 @@ bool operator==(const JSONObject::JSONValue& lhs, const JSONObject::JSONValue& r
             return lhs.double_val == rhs.double_val;
         } break;
         
+        case JSONObject::ValueType::KEY:
         case JSONObject::ValueType::STR:
         {
             return lhs.str_val == rhs.str_val;
@@ -598,28 +2504,20 @@ bool operator!=(const JSONObject::JSONValue& lhs, const JSONObject::JSONValue& r
 
 std::ostream& operator<<(std::ostream& out, const JSONObject& obj)
 {
-    out << "{\n";
-    obj.RecPrint(1, out);
-    out << "}\n";
+    JSONSerializer serializer(JSONSerializer::Style::PRETTY);
+    serializer.Write(obj);
+    std::string_view text = serializer.View();
 
-    return out;
+    return out.write(text.data(), text.size()) << "\n";
 }
 
 std::ostream& operator<<(std::ostream& out, const JSONObject::JSONValue& value)
 {
-    value.PrintValueByType(0, out);
-    return out;
-}
-
-void JSONObject::RecPrint(u8 indent, std::ostream& out) const
-{
-    for (std::string key : insertion_order)
-    {
-        const JSONObject::JSONValue* value = json.at(key);
+    JSONSerializer serializer;
+    serializer.Write(value);
+    std::string_view text = serializer.View();
 
-        out << std::string(indent, '\t') << "\"" + key + "\": ";
-        value->PrintValueByType(indent, out);
-    }
+    return out.write(text.data(), text.size());
 }
 
 } // namespace JSORON
@@ -0,0 +1,671 @@
+/* ------------------------------------------*/
+/* Filename: JSONPatch.cpp                   */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+
+#include "JSONPatch.h"
+#include "NumberFormat.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    /**
+     * NOTE(19.10.26): packed elements are scalars, they are copied into scratch so the
+     * array is not unpacked for a read
+     */
+    const JSONValue& ElementAt(const JSONArray& arr, u64 index, JSONValue& scratch)
+    {
+        if (arr.GetStorage() == JSONArray::Storage::GENERIC)
+        {
+            return arr.At(index);
+        }
+
+        scratch = arr.ValueAt(index);
+        return scratch;
+    }
+
+    b8 SameElement(const JSONArray& lhs, u64 lhs_index, const JSONArray& rhs, u64 rhs_index)
+    {
+        JSONValue lhs_scratch;
+        JSONValue rhs_scratch;
+        return ElementAt(lhs, lhs_index, lhs_scratch) == ElementAt(rhs, rhs_index, rhs_scratch);
+    }
+
+    void AppendIndex(std::string& path, u64 index)
+    {
+        char digits[max_int_chars];
+        path.push_back('/');
+        path.append(digits, FormatUInt(digits, index));
+    }
+}
+
+/**************************************************************************************************
+ *
+ *  Diff
+ *
+ **************************************************************************************************/
+
+JSONArray JSONPatch::Diff(const JSONObject& from, const JSONObject& to)
+{
+    JSONArray patch;
+    std::string path;
+    DiffObject(from, to, path, patch);
+    return patch;
+}
+
+void JSONPatch::DiffValue(const JSONValue& from, const JSONValue& to, std::string& path, JSONArray& patch)
+{
+    if (from.type == JSONObject::ValueType::JSON_OBJECT && to.type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        DiffObject(*from.json_val, *to.json_val, path, patch);
+        return;
+    }
+
+    if (from.type == JSONObject::ValueType::ARR && to.type == JSONObject::ValueType::ARR)
+    {
+        DiffArray(from.json_arr, to.json_arr, path, patch);
+        return;
+    }
+
+    if (from != to)
+    {
+        PushOp(patch, "replace", path, &to);
+    }
+}
+
+void JSONPatch::DiffObject(const JSONObject& from, const JSONObject& to, std::string& path, JSONArray& patch)
+{
+    // NOTE(19.10.26): a shared body or a different hash answers this without a walk
+    if (from == to)
+    {
+        return;
+    }
+
+    const JSONObject::Body& from_body = from.Read();
+    const JSONObject::Body& to_body = to.Read();
+    u64 path_size = path.size();
+
+    // NOTE(19.10.26): members are compared in order, the patch must rebuild the order of
+    // to. the members of to up to kept_end that from has in the same order stay where they
+    // are, "add" appends, so every later member of to is removed if from has it and added
+    u64 kept_end = 0;
+    for (const JSONObject::Member& member : from_body.members)
+    {
+        if (member.IsRemoved() || to_body.Find(member.key, member.hash) < 0)
+        {
+            continue;
+        }
+
+        while (kept_end < to_body.members.size() && to_body.members[kept_end].IsRemoved())
+        {
+            ++kept_end;
+        }
+
+        if (kept_end == to_body.members.size() || to_body.members[kept_end].hash != member.hash ||
+            to_body.members[kept_end].key != member.key)
+        {
+            break;
+        }
+        ++kept_end;
+    }
+
+    for (const JSONObject::Member& member : from_body.members)
+    {
+        if (member.IsRemoved())
+        {
+            continue;
+        }
+
+        AppendToken(path, member.key);
+
+        s64 slot = to_body.Find(member.key, member.hash);
+        if (slot < 0 || (u64)slot >= kept_end)
+        {
+            PushOp(patch, "remove", path, nullptr);
+        }
+        else
+        {
+            DiffValue(member.value, to_body.members[slot].value, path, patch);
+        }
+
+        path.resize(path_size);
+    }
+
+    for (u64 slot = kept_end; slot < to_body.members.size(); ++slot)
+    {
+        const JSONObject::Member& member = to_body.members[slot];
+        if (!member.IsRemoved())
+        {
+            AppendToken(path, member.key);
+            PushOp(patch, "add", path, &member.value);
+            path.resize(path_size);
+        }
+    }
+}
+
+void JSONPatch::DiffArray(const JSONArray& from, const JSONArray& to, std::string& path, JSONArray& patch)
+{
+    if (from == to)
+    {
+        return;
+    }
+
+    u64 from_size = from.Size();
+    u64 to_size = to.Size();
+
+    u64 prefix = 0;
+    while (prefix < from_size && prefix < to_size && SameElement(from, prefix, to, prefix))
+    {
+        ++prefix;
+    }
+
+    u64 suffix = 0;
+    while (suffix < from_size - prefix && suffix < to_size - prefix &&
+           SameElement(from, from_size - 1 - suffix, to, to_size - 1 - suffix))
+    {
+        ++suffix;
+    }
+
+    // NOTE(19.10.26): the changed middle, from[prefix, from_end) becomes to[prefix, to_end).
+    // the overlap is diffed element by element and the extra elements of the longer side
+    // are removed or added as one run, at the front or the back of the middle, whichever
+    // lines up more equal pairs. one insertion or deletion next to edits stays one op
+    u64 from_end = from_size - suffix;
+    u64 to_end = to_size - suffix;
+    u64 common = std::min(from_end, to_end) - prefix;
+    u64 from_shift = from_end - prefix - common;
+    u64 to_shift = to_end - prefix - common;
+
+    b8 run_at_front = 0;
+    if (from_shift + to_shift > 0)
+    {
+        u64 back_matches = 0;
+        u64 front_matches = 0;
+        for (u64 index = prefix; index < prefix + common; ++index)
+        {
+            back_matches += SameElement(from, index, to, index);
+            front_matches += SameElement(from, index + from_shift, to, index + to_shift);
+        }
+        run_at_front = front_matches > back_matches;
+    }
+
+    u64 run_index = run_at_front ? prefix : prefix + common;
+    u64 path_size = path.size();
+    JSONValue from_scratch;
+    JSONValue to_scratch;
+
+    auto emit_run = [&]()
+    {
+        AppendIndex(path, run_index);
+        for (u64 count = 0; count < from_shift; ++count)
+        {
+            PushOp(patch, "remove", path, nullptr);
+        }
+        path.resize(path_size);
+
+        for (u64 count = 0; count < to_shift; ++count)
+        {
+            AppendIndex(path, run_index + count);
+            PushOp(patch, "add", path, &ElementAt(to, run_index + count, to_scratch));
+            path.resize(path_size);
+        }
+    };
+
+    if (run_at_front)
+    {
+        emit_run();
+    }
+
+    // NOTE(19.10.26): once the run is in place every pair sits at its index in to
+    u64 from_offset = run_at_front ? from_shift : 0;
+    u64 to_offset = run_at_front ? to_shift : 0;
+    for (u64 index = prefix; index < prefix + common; ++index)
+    {
+        AppendIndex(path, index + to_offset);
+        DiffValue(ElementAt(from, index + from_offset, from_scratch), ElementAt(to, index + to_offset, to_scratch),
+                  path, patch);
+        path.resize(path_size);
+    }
+
+    if (!run_at_front)
+    {
+        emit_run();
+    }
+}
+
+void JSONPatch::PushOp(JSONArray& patch, const char *op, const std::string& path, const JSONValue *value)
+{
+    JSONObject op_obj;
+    op_obj.Emplace("op", std::string(op));
+    op_obj.Emplace("path", path);
+    if (value)
+    {
+        op_obj.Emplace("value", *value);
+    }
+
+    patch.PushBack(JSONValue(std::move(op_obj)));
+}
+
+/**************************************************************************************************
+ *
+ *  Apply
+ *
+ **************************************************************************************************/
+
+b8 JSONPatch::Apply(JSONObject& doc, const JSONArray& patch)
+{
+    // NOTE(19.10.26): the operations run on a copy, copying is O(1) and only the paths
+    // the patch touches are detached. doc is replaced once every operation succeeded
+    JSONValue root(doc);
+    for (u64 index = 0; index < patch.Size(); ++index)
+    {
+        JSONValue op = patch.ValueAt(index);
+        if (op.type != JSONObject::ValueType::JSON_OBJECT || !ApplyOp(root, *op.json_val))
+        {
+            return 0;
+        }
+    }
+
+    if (root.type != JSONObject::ValueType::JSON_OBJECT)
+    {
+        return 0;
+    }
+
+    doc = std::move(*root.json_val);
+    return 1;
+}
+
+b8 JSONPatch::ApplyOp(JSONValue& root, const JSONObject& op)
+{
+    const JSONValue& name = op[std::string_view("op")];
+    const JSONValue& path = op[std::string_view("path")];
+    if (name.type != JSONObject::ValueType::STR || path.type != JSONObject::ValueType::STR)
+    {
+        return 0;
+    }
+
+    Tokens tokens;
+    if (!SplitPointer(path.str_val, tokens))
+    {
+        return 0;
+    }
+
+    const JSONValue& value = op[std::string_view("value")];
+    const std::string& op_name = name.str_val;
+    if (op_name == "add" || op_name == "replace" || op_name == "test")
+    {
+        if (value.type == JSONObject::ValueType::BAD_TYPE)
+        {
+            return 0;
+        }
+
+        if (op_name == "add")
+        {
+            return Add(root, tokens, value);
+        }
+
+        if (op_name == "replace")
+        {
+            return Replace(root, tokens, value);
+        }
+
+        JSONValue current;
+        return Find(root, tokens, current) && current == value;
+    }
+
+    if (op_name == "remove")
+    {
+        return Remove(root, tokens);
+    }
+
+    if (op_name == "move" || op_name == "copy")
+    {
+        const JSONValue& from = op[std::string_view("from")];
+        Tokens from_tokens;
+        if (from.type != JSONObject::ValueType::STR || !SplitPointer(from.str_val, from_tokens))
+        {
+            return 0;
+        }
+
+        JSONValue moved;
+        if (!Find(root, from_tokens, moved))
+        {
+            return 0;
+        }
+
+        if (op_name == "copy")
+        {
+            return Add(root, tokens, moved);
+        }
+
+        // NOTE(19.10.26): a value can't be moved into one of its own children
+        if (from_tokens.size() < tokens.size() &&
+            std::equal(from_tokens.begin(), from_tokens.end(), tokens.begin()))
+        {
+            return 0;
+        }
+
+        return Remove(root, from_tokens) && Add(root, tokens, moved);
+    }
+
+    return 0;
+}
+
+b8 JSONPatch::Add(JSONValue& root, const Tokens& tokens, const JSONValue& value)
+{
+    if (tokens.empty())
+    {
+        root = value;
+        return 1;
+    }
+
+    JSONValue *parent = Locate(root, tokens, tokens.size() - 1);
+    if (!parent)
+    {
+        return 0;
+    }
+
+    const std::string& last = tokens.back();
+    if (parent->type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        JSONObject& obj = *parent->json_val;
+        JSONValue& member = obj[std::string_view(last)];
+        if (member.type == JSONObject::ValueType::BAD_TYPE)
+        {
+            obj.Emplace(last, value);
+        }
+        else
+        {
+            member = value;
+        }
+
+        return 1;
+    }
+
+    JSONArray& arr = parent->json_arr;
+    u64 index = arr.Size();
+    if (last != "-" && (!ParseIndex(last, index) || index > arr.Size()))
+    {
+        return 0;
+    }
+
+    arr.Insert(index, JSONValue(value));
+    return 1;
+}
+
+b8 JSONPatch::Remove(JSONValue& root, const Tokens& tokens)
+{
+    if (tokens.empty())
+    {
+        return 0;
+    }
+
+    JSONValue *parent = Locate(root, tokens, tokens.size() - 1);
+    if (!parent)
+    {
+        return 0;
+    }
+
+    if (parent->type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        return parent->json_val->Remove(tokens.back());
+    }
+
+    JSONArray& arr = parent->json_arr;
+    u64 index;
+    if (!ParseIndex(tokens.back(), index) || index >= arr.Size())
+    {
+        return 0;
+    }
+
+    arr.Erase(index);
+    return 1;
+}
+
+b8 JSONPatch::Replace(JSONValue& root, const Tokens& tokens, const JSONValue& value)
+{
+    if (tokens.empty())
+    {
+        root = value;
+        return 1;
+    }
+
+    JSONValue *parent = Locate(root, tokens, tokens.size() - 1);
+    if (!parent)
+    {
+        return 0;
+    }
+
+    if (parent->type == JSONObject::ValueType::JSON_OBJECT)
+    {
+        JSONValue& member = (*parent->json_val)[std::string_view(tokens.back())];
+        if (member.type == JSONObject::ValueType::BAD_TYPE)
+        {
+            return 0;
+        }
+
+        member = value;
+        return 1;
+    }
+
+    JSONArray& arr = parent->json_arr;
+    u64 index;
+    if (!ParseIndex(tokens.back(), index) || index >= arr.Size())
+    {
+        return 0;
+    }
+
+    // NOTE(19.10.26): a number of the packed type is written in place, the array stays packed
+    if (arr.GetStorage() == JSONArray::Storage::INTS && value.type == JSONObject::ValueType::INT)
+    {
+        arr.Ints()[index] = value.int_val;
+    }
+    else if (arr.GetStorage() == JSONArray::Storage::DOUBLES && value.type == JSONObject::ValueType::DOUBLE)
+    {
+        arr.Doubles()[index] = value.double_val;
+    }
+    else
+    {
+        arr.At(index) = value;
+    }
+
+    return 1;
+}
+
+b8 JSONPatch::Find(const JSONValue& root, const Tokens& tokens, JSONValue& out)
+{
+    const JSONValue *current = &root;
+    JSONValue row;
+    for (u64 at = 0; at < tokens.size(); ++at)
+    {
+        if (current->type == JSONObject::ValueType::JSON_OBJECT)
+        {
+            const JSONObject& obj = *current->json_val;
+            const JSONValue& member = obj[std::string_view(tokens[at])];
+            if (member.type == JSONObject::ValueType::BAD_TYPE)
+            {
+                return 0;
+            }
+
+            current = &member;
+            continue;
+        }
+
+        if (current->type != JSONObject::ValueType::ARR)
+        {
+            return 0;
+        }
+
+        const JSONArray& arr = current->json_arr;
+        u64 index;
+        if (!ParseIndex(tokens[at], index) || index >= arr.Size())
+        {
+            return 0;
+        }
+
+        if (arr.GetStorage() != JSONArray::Storage::GENERIC)
+        {
+            if (at + 1 == tokens.size())
+            {
+                out = arr.ValueAt(index);
+                return 1;
+            }
+
+            if (arr.GetStorage() != JSONArray::Storage::TABLE)
+            {
+                return 0;
+            }
+
+            // NOTE(19.10.26): the row is copied out of the table, arr may live inside the
+            // previous row so that one is replaced only after the copy
+            JSONValue next = arr.ValueAt(index);
+            row = std::move(next);
+            current = &row;
+            continue;
+        }
+
+        current = &arr.At(index);
+    }
+
+    out = *current;
+    return 1;
+}
+
+JSONValue* JSONPatch::Locate(JSONValue& root, const Tokens& tokens, u64 count)
+{
+    // NOTE(19.10.26): the non const lookups detach every body on the way down, so the
+    // operation only changes the copy in Apply
+    JSONValue *current = &root;
+    for (u64 at = 0; at < count; ++at)
+    {
+        if (current->type == JSONObject::ValueType::JSON_OBJECT)
+        {
+            JSONValue& member = (*current->json_val)[std::string_view(tokens[at])];
+            if (member.type == JSONObject::ValueType::BAD_TYPE)
+            {
+                return nullptr;
+            }
+
+            current = &member;
+            continue;
+        }
+
+        if (current->type != JSONObject::ValueType::ARR)
+        {
+            return nullptr;
+        }
+
+        JSONArray& arr = current->json_arr;
+        u64 index;
+        if (!ParseIndex(tokens[at], index) || index >= arr.Size() ||
+            arr.GetStorage() == JSONArray::Storage::INTS || arr.GetStorage() == JSONArray::Storage::DOUBLES)
+        {
+            return nullptr;
+        }
+
+        current = &arr.At(index);
+    }
+
+    if (current->type != JSONObject::ValueType::JSON_OBJECT && current->type != JSONObject::ValueType::ARR)
+    {
+        return nullptr;
+    }
+
+    return current;
+}
+
+/**************************************************************************************************
+ *
+ *  JSON Pointer
+ *
+ **************************************************************************************************/
+
+void JSONPatch::AppendToken(std::string& pointer, std::string_view token)
+{
+    pointer.push_back('/');
+    for (char c : token)
+    {
+        if (c == '~')
+        {
+            pointer.append("~0");
+        }
+        else if (c == '/')
+        {
+            pointer.append("~1");
+        }
+        else
+        {
+            pointer.push_back(c);
+        }
+    }
+}
+
+b8 JSONPatch::SplitPointer(std::string_view pointer, std::vector<std::string>& tokens)
+{
+    tokens.clear();
+    if (pointer.empty())
+    {
+        return 1;
+    }
+
+    if (pointer[0] != '/')
+    {
+        return 0;
+    }
+
+    std::string token;
+    for (u64 at = 1; at <= pointer.size(); ++at)
+    {
+        if (at == pointer.size() || pointer[at] == '/')
+        {
+            tokens.push_back(std::move(token));
+            token.clear();
+            continue;
+        }
+
+        if (pointer[at] != '~')
+        {
+            token.push_back(pointer[at]);
+            continue;
+        }
+
+        if (at + 1 == pointer.size() || (pointer[at + 1] != '0' && pointer[at + 1] != '1'))
+        {
+            return 0;
+        }
+
+        ++at;
+        token.push_back(pointer[at] == '0' ? '~' : '/');
+    }
+
+    return 1;
+}
+
+b8 JSONPatch::ParseIndex(std::string_view token, u64& index)
+{
+    // NOTE(19.10.26): no sign, no leading zeros, short enough not to overflow
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0'))
+    {
+        return 0;
+    }
+
+    index = 0;
+    for (char c : token)
+    {
+        if (c < '0' || c > '9')
+        {
+            return 0;
+        }
+
+        index = index * 10 + (c - '0');
+    }
+
+    return 1;
+}
+
+} // namespace JSORON
@@ -0,0 +1,882 @@
+/* ------------------------------------------*/
+/* Filename: JSONPath.cpp                    */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+
+#include "JSONPath.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    typedef JSONObject::ValueType ValueType;
+    typedef JSONObject::JSONArray JSONArray;
+
+    const JSONArray* ArrayOf(const PathValue& node)
+    {
+        const JSONValue *value = node.Value();
+        return value && value->type == ValueType::ARR ? &value->json_arr : nullptr;
+    }
+
+    /**
+     * @return index inside [0, size), a negative index counts from the end. 0 if out of range
+     */
+    b8 Normalize(s64 index, u64 size, u64& out)
+    {
+        if (index < 0)
+        {
+            index += (s64)size;
+        }
+
+        if (index < 0 || (u64)index >= size)
+        {
+            return 0;
+        }
+
+        out = (u64)index;
+        return 1;
+    }
+
+    b8 IsNameChar(char c)
+    {
+        return std::isalnum((unsigned char)c) || c == '_' || c == '-' || c == '$' || (unsigned char)c >= 0x80;
+    }
+
+    b8 IsNumber(ValueType type)
+    {
+        return type == ValueType::INT || type == ValueType::DOUBLE;
+    }
+}
+
+PathValue::PathValue(const JSONValue& value) : kind(Kind::VALUE), value(&value), obj(nullptr), arr(nullptr), index(0)
+{
+    if (value.type == ValueType::JSON_OBJECT)
+    {
+        obj = value.json_val;
+    }
+}
+
+PathValue PathValue::ElementOf(const JSONArray& arr, u64 index)
+{
+    switch (arr.GetStorage())
+    {
+        case JSONArray::Storage::INTS:
+        case JSONArray::Storage::DOUBLES:
+        {
+            return PathValue(Kind::ELEMENT, arr, index);
+        }
+
+        case JSONArray::Storage::TABLE:
+        {
+            return PathValue(Kind::ROW, arr, index);
+        }
+
+        case JSONArray::Storage::GENERIC:
+        {
+        } break;
+    }
+
+    return PathValue(arr.At(index));
+}
+
+JSONObject::ValueType PathValue::Type() const
+{
+    switch (kind)
+    {
+        case Kind::OBJECT:
+        case Kind::ROW:
+        {
+            return ValueType::JSON_OBJECT;
+        }
+
+        case Kind::VALUE:
+        {
+            return value->type;
+        }
+
+        case Kind::ELEMENT:
+        {
+            return arr->GetStorage() == JSONArray::Storage::INTS ? ValueType::INT : ValueType::DOUBLE;
+        }
+
+        case Kind::NONE:
+        {
+        } break;
+    }
+
+    return ValueType::BAD_TYPE;
+}
+
+s32 PathValue::AsInt() const
+{
+    switch (Type())
+    {
+        case ValueType::INT:
+        {
+            return kind == Kind::ELEMENT ? arr->Ints()[index] : value->int_val;
+        }
+
+        case ValueType::DOUBLE:
+        {
+            return (s32)AsDouble();
+        }
+
+        default:
+        {
+        } break;
+    }
+
+    return 0;
+}
+
+f64 PathValue::AsDouble() const
+{
+    switch (Type())
+    {
+        case ValueType::INT:
+        {
+            return AsInt();
+        }
+
+        case ValueType::DOUBLE:
+        {
+            return kind == Kind::ELEMENT ? arr->Doubles()[index] : value->double_val;
+        }
+
+        default:
+        {
+        } break;
+    }
+
+    return 0;
+}
+
+std::string_view PathValue::AsStr() const
+{
+    if (kind == Kind::VALUE && (value->type == ValueType::STR || value->type == ValueType::KEY))
+    {
+        return value->str_val;
+    }
+
+    return std::string_view();
+}
+
+JSONValue PathValue::Copy() const
+{
+    switch (kind)
+    {
+        case Kind::OBJECT:
+        {
+            return JSONValue(*obj);
+        }
+
+        case Kind::VALUE:
+        {
+            return *value;
+        }
+
+        case Kind::ELEMENT:
+        case Kind::ROW:
+        {
+            return arr->ValueAt(index);
+        }
+
+        case Kind::NONE:
+        {
+        } break;
+    }
+
+    return JSONValue(ValueType::BAD_TYPE);
+}
+
+PathValue PathValue::Child(const Key& key) const
+{
+    if (kind == Kind::ROW)
+    {
+        const JSONArray *column = arr->Column(key);
+        return column ? ElementOf(*column, index) : PathValue();
+    }
+
+    if (!obj)
+    {
+        return PathValue();
+    }
+
+    const JSONValue& member = (*obj)[key];
+    return member.type == ValueType::BAD_TYPE ? PathValue() : PathValue(member);
+}
+
+b8 JSONPath::Compile(std::string_view expression)
+{
+    steps.clear();
+    compiled = 0;
+
+    std::string_view rest = expression;
+    SkipSpaces(rest);
+    if (rest.empty() || rest[0] != '$')
+    {
+        return 0;
+    }
+    rest.remove_prefix(1);
+
+    for (;;)
+    {
+        SkipSpaces(rest);
+        if (rest.empty())
+        {
+            break;
+        }
+
+        Step step;
+        if (!ParseStep(rest, step))
+        {
+            steps.clear();
+            return 0;
+        }
+
+        steps.push_back(std::move(step));
+    }
+
+    compiled = 1;
+    return 1;
+}
+
+u64 JSONPath::Select(const JSONObject& doc, std::vector<PathValue>& out) const
+{
+    u64 size = out.size();
+    Run(doc, [&out](const PathValue& match) { out.push_back(match); });
+    return out.size() - size;
+}
+
+void JSONPath::Evaluate(const JSONObject& doc, Sink& sink) const
+{
+    if (!compiled)
+    {
+        return;
+    }
+
+    Apply(PathValue(doc), 0, sink);
+}
+
+void JSONPath::Apply(const PathValue& node, u64 step, Sink& sink) const
+{
+    if (step == steps.size())
+    {
+        sink.Emit(node);
+        return;
+    }
+
+    ApplyHere(node, step, sink);
+
+    // NOTE(19.10.26): .. applies the step to the node and to everything below it
+    if (steps[step].descendants)
+    {
+        node.ForEachChild([&](const PathValue& child) { Apply(child, step, sink); });
+    }
+}
+
+void JSONPath::ApplyHere(const PathValue& node, u64 step, Sink& sink) const
+{
+    const Step& current = steps[step];
+    switch (current.type)
+    {
+        case StepType::CHILD:
+        {
+            PathValue child = node.Child(current.token.GetKey());
+            if (child.GetKind() != PathValue::Kind::NONE)
+            {
+                Apply(child, step + 1, sink);
+            }
+        } break;
+
+        case StepType::WILDCARD:
+        {
+            // NOTE(19.10.26): [*].name over a TABLE array finds the column once and walks it
+            const JSONArray *arr = ArrayOf(node);
+            if (arr && arr->GetStorage() == JSONArray::Storage::TABLE && step + 1 < steps.size() &&
+                steps[step + 1].type == StepType::CHILD && !steps[step + 1].descendants)
+            {
+                const JSONArray *column = arr->Column(steps[step + 1].token.GetKey());
+                for (u64 index = 0; column && index < column->Size(); ++index)
+                {
+                    Apply(PathValue::ElementOf(*column, index), step + 2, sink);
+                }
+                break;
+            }
+
+            node.ForEachChild([&](const PathValue& child) { Apply(child, step + 1, sink); });
+        } break;
+
+        case StepType::INDEX:
+        {
+            const JSONArray *arr = ArrayOf(node);
+            u64 index = 0;
+            if (arr && Normalize(current.token.index, arr->Size(), index))
+            {
+                Apply(PathValue::ElementOf(*arr, index), step + 1, sink);
+            }
+        } break;
+
+        case StepType::SLICE:
+        {
+            const JSONArray *arr = ArrayOf(node);
+            if (!arr)
+            {
+                break;
+            }
+
+            // NOTE(19.10.26): python slicing, the bounds are clamped and a negative stride
+            // walks from the end
+            s64 size = (s64)arr->Size();
+            s64 stride = current.stride;
+            s64 low = stride > 0 ? 0 : -1;
+            s64 high = stride > 0 ? size : size - 1;
+            s64 start = stride > 0 ? low : high;
+            s64 end = stride > 0 ? high : low;
+            if (current.has_start)
+            {
+                start = current.start < 0 ? current.start + size : current.start;
+                start = start < low ? low : (start > high ? high : start);
+            }
+            if (current.has_end)
+            {
+                end = current.end < 0 ? current.end + size : current.end;
+                end = end < low ? low : (end > high ? high : end);
+            }
+
+            for (s64 index = start; stride > 0 ? index < end : index > end; index += stride)
+            {
+                Apply(PathValue::ElementOf(*arr, (u64)index), step + 1, sink);
+            }
+        } break;
+
+        case StepType::FILTER:
+        {
+            node.ForEachChild([&](const PathValue& child)
+            {
+                if (Holds(current.filter, child))
+                {
+                    Apply(child, step + 1, sink);
+                }
+            });
+        } break;
+    }
+}
+
+b8 JSONPath::Holds(const std::vector<std::vector<Condition>>& filter, const PathValue& node)
+{
+    for (const std::vector<Condition>& conjunction : filter)
+    {
+        b8 holds = 1;
+        for (const Condition& condition : conjunction)
+        {
+            if (!Holds(condition, node))
+            {
+                holds = 0;
+                break;
+            }
+        }
+
+        if (holds)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+b8 JSONPath::Holds(const Condition& condition, const PathValue& node)
+{
+    PathValue at = node;
+    for (const Token& token : condition.path)
+    {
+        if (token.is_index)
+        {
+            const JSONArray *arr = ArrayOf(at);
+            u64 index = 0;
+            if (!arr || !Normalize(token.index, arr->Size(), index))
+            {
+                return 0;
+            }
+            at = PathValue::ElementOf(*arr, index);
+        }
+        else
+        {
+            at = at.Child(token.GetKey());
+        }
+
+        if (at.GetKind() == PathValue::Kind::NONE)
+        {
+            return 0;
+        }
+    }
+
+    if (condition.compare == Compare::EXISTS)
+    {
+        return 1;
+    }
+
+    ValueType type = at.Type();
+    ValueType literal_type = condition.literal.type;
+    if (IsNumber(type) && IsNumber(literal_type))
+    {
+        if (type == ValueType::INT && literal_type == ValueType::INT)
+        {
+            return Matches<s32>(condition.compare, at.AsInt(), condition.literal.int_val);
+        }
+
+        f64 literal = literal_type == ValueType::INT ? condition.literal.int_val : condition.literal.double_val;
+        return Matches<f64>(condition.compare, at.AsDouble(), literal);
+    }
+
+    if ((type == ValueType::STR || type == ValueType::KEY) && literal_type == ValueType::STR)
+    {
+        return Matches<std::string_view>(condition.compare, at.AsStr(), condition.literal.str_val);
+    }
+
+    if (type == ValueType::NULL_TYPE && literal_type == ValueType::NULL_TYPE)
+    {
+        return condition.compare == Compare::EQ;
+    }
+
+    // NOTE(19.10.26): values of different types are only ever unequal
+    return condition.compare == Compare::NE;
+}
+
+b8 JSONPath::ParseStep(std::string_view& rest, Step& step)
+{
+    if (rest.substr(0, 2) == "..")
+    {
+        step.descendants = 1;
+        rest.remove_prefix(2);
+        if (!rest.empty() && rest[0] == '[')
+        {
+            return ParseBracket(rest, step);
+        }
+    }
+    else if (rest[0] == '.')
+    {
+        rest.remove_prefix(1);
+    }
+    else if (rest[0] == '[')
+    {
+        return ParseBracket(rest, step);
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (!rest.empty() && rest[0] == '*')
+    {
+        rest.remove_prefix(1);
+        step.type = StepType::WILDCARD;
+        return 1;
+    }
+
+    step.type = StepType::CHILD;
+    return ParseName(rest, step.token);
+}
+
+b8 JSONPath::ParseBracket(std::string_view& rest, Step& step)
+{
+    rest.remove_prefix(1);
+    SkipSpaces(rest);
+    if (rest.empty())
+    {
+        return 0;
+    }
+
+    if (rest[0] == '*')
+    {
+        rest.remove_prefix(1);
+        step.type = StepType::WILDCARD;
+    }
+    else if (rest[0] == '\'' || rest[0] == '"')
+    {
+        step.type = StepType::CHILD;
+        if (!ParseToken(rest, step.token))
+        {
+            return 0;
+        }
+    }
+    else if (rest[0] == '?')
+    {
+        if (!ParseFilter(rest, step))
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        if (rest[0] != ':')
+        {
+            if (!ParseInt(rest, step.start))
+            {
+                return 0;
+            }
+            step.has_start = 1;
+            SkipSpaces(rest);
+        }
+
+        if (rest.empty() || rest[0] != ':')
+        {
+            if (!step.has_start)
+            {
+                return 0;
+            }
+
+            step.type = StepType::INDEX;
+            step.token.index = step.start;
+            step.token.is_index = 1;
+        }
+        else
+        {
+            step.type = StepType::SLICE;
+            rest.remove_prefix(1);
+            SkipSpaces(rest);
+            if (!rest.empty() && rest[0] != ':' && rest[0] != ']')
+            {
+                if (!ParseInt(rest, step.end))
+                {
+                    return 0;
+                }
+                step.has_end = 1;
+                SkipSpaces(rest);
+            }
+
+            if (!rest.empty() && rest[0] == ':')
+            {
+                rest.remove_prefix(1);
+                SkipSpaces(rest);
+                if (!rest.empty() && rest[0] != ']' && (!ParseInt(rest, step.stride) || step.stride == 0))
+                {
+                    return 0;
+                }
+            }
+        }
+    }
+
+    SkipSpaces(rest);
+    if (rest.empty() || rest[0] != ']')
+    {
+        return 0;
+    }
+
+    rest.remove_prefix(1);
+    return 1;
+}
+
+b8 JSONPath::ParseFilter(std::string_view& rest, Step& step)
+{
+    rest.remove_prefix(1);
+    SkipSpaces(rest);
+    if (rest.empty() || rest[0] != '(')
+    {
+        return 0;
+    }
+    rest.remove_prefix(1);
+
+    step.type = StepType::FILTER;
+    step.filter.emplace_back();
+    for (;;)
+    {
+        SkipSpaces(rest);
+        Condition condition;
+        if (!ParseCondition(rest, condition))
+        {
+            return 0;
+        }
+        step.filter.back().push_back(std::move(condition));
+
+        SkipSpaces(rest);
+        if (rest.substr(0, 2) == "&&")
+        {
+            rest.remove_prefix(2);
+        }
+        else if (rest.substr(0, 2) == "||")
+        {
+            rest.remove_prefix(2);
+            step.filter.emplace_back();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (rest.empty() || rest[0] != ')')
+    {
+        return 0;
+    }
+
+    rest.remove_prefix(1);
+    return 1;
+}
+
+b8 JSONPath::ParseCondition(std::string_view& rest, Condition& condition)
+{
+    if (rest.empty() || rest[0] != '@')
+    {
+        return 0;
+    }
+    rest.remove_prefix(1);
+
+    for (;;)
+    {
+        Token token;
+        if (!rest.empty() && rest[0] == '.')
+        {
+            rest.remove_prefix(1);
+            if (!ParseName(rest, token))
+            {
+                return 0;
+            }
+        }
+        else if (!rest.empty() && rest[0] == '[')
+        {
+            rest.remove_prefix(1);
+            SkipSpaces(rest);
+            if (!ParseToken(rest, token))
+            {
+                return 0;
+            }
+
+            SkipSpaces(rest);
+            if (rest.empty() || rest[0] != ']')
+            {
+                return 0;
+            }
+            rest.remove_prefix(1);
+        }
+        else
+        {
+            break;
+        }
+
+        condition.path.push_back(std::move(token));
+    }
+
+    SkipSpaces(rest);
+    static const std::pair<std::string_view, Compare> operators[] =
+    {
+        {"==", Compare::EQ}, {"!=", Compare::NE}, {"<=", Compare::LE},
+        {">=", Compare::GE}, {"<", Compare::LT}, {">", Compare::GT}
+    };
+
+    condition.compare = Compare::EXISTS;
+    for (const std::pair<std::string_view, Compare>& op : operators)
+    {
+        if (rest.substr(0, op.first.size()) == op.first)
+        {
+            rest.remove_prefix(op.first.size());
+            condition.compare = op.second;
+            break;
+        }
+    }
+
+    if (condition.compare == Compare::EXISTS)
+    {
+        return 1;
+    }
+
+    SkipSpaces(rest);
+    return ParseLiteral(rest, condition.literal);
+}
+
+b8 JSONPath::ParseName(std::string_view& rest, Token& token)
+{
+    u64 length = 0;
+    while (length < rest.size() && IsNameChar(rest[length]))
+    {
+        ++length;
+    }
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    token.name = std::string(rest.substr(0, length));
+    token.hash = HashKey(token.name);
+    token.is_index = 0;
+    rest.remove_prefix(length);
+    return 1;
+}
+
+b8 JSONPath::ParseQuoted(std::string_view& rest, std::string& str)
+{
+    char quote = rest[0];
+    rest.remove_prefix(1);
+
+    str.clear();
+    while (!rest.empty() && rest[0] != quote)
+    {
+        if (rest[0] == '\\' && rest.size() > 1)
+        {
+            rest.remove_prefix(1);
+        }
+
+        str.push_back(rest[0]);
+        rest.remove_prefix(1);
+    }
+
+    if (rest.empty())
+    {
+        return 0;
+    }
+
+    rest.remove_prefix(1);
+    return 1;
+}
+
+b8 JSONPath::ParseToken(std::string_view& rest, Token& token)
+{
+    if (rest.empty())
+    {
+        return 0;
+    }
+
+    if (rest[0] == '\'' || rest[0] == '"')
+    {
+        if (!ParseQuoted(rest, token.name))
+        {
+            return 0;
+        }
+
+        token.hash = HashKey(token.name);
+        token.is_index = 0;
+        return 1;
+    }
+
+    token.is_index = 1;
+    return ParseInt(rest, token.index);
+}
+
+b8 JSONPath::ParseInt(std::string_view& rest, s64& num)
+{
+    b8 negative = !rest.empty() && rest[0] == '-';
+    u64 at = negative ? 1 : 0;
+    if (at >= rest.size() || !std::isdigit((unsigned char)rest[at]))
+    {
+        return 0;
+    }
+
+    num = 0;
+    while (at < rest.size() && std::isdigit((unsigned char)rest[at]))
+    {
+        num = num * 10 + (rest[at] - '0');
+        ++at;
+    }
+
+    num = negative ? -num : num;
+    rest.remove_prefix(at);
+    return 1;
+}
+
+b8 JSONPath::ParseLiteral(std::string_view& rest, JSONValue& literal)
+{
+    if (rest.empty())
+    {
+        return 0;
+    }
+
+    if (rest[0] == '\'' || rest[0] == '"')
+    {
+        std::string str;
+        if (!ParseQuoted(rest, str))
+        {
+            return 0;
+        }
+
+        literal = JSONValue(std::move(str));
+        return 1;
+    }
+
+    // NOTE(19.10.26): true and false are read as the ints 1 and 0, like the parser does
+    static const std::pair<std::string_view, s32> words[] = {{"true", 1}, {"false", 0}};
+    for (const std::pair<std::string_view, s32>& word : words)
+    {
+        if (rest.substr(0, word.first.size()) == word.first)
+        {
+            rest.remove_prefix(word.first.size());
+            literal = JSONValue(word.second);
+            return 1;
+        }
+    }
+
+    if (rest.substr(0, 4) == "null")
+    {
+        rest.remove_prefix(4);
+        literal = JSONValue(ValueType::NULL_TYPE);
+        return 1;
+    }
+
+    u64 length = 0;
+    b8 is_double = 0;
+    while (length < rest.size() && (std::isdigit((unsigned char)rest[length]) || rest[length] == '-' ||
+           rest[length] == '+' || rest[length] == '.' || rest[length] == 'e' || rest[length] == 'E'))
+    {
+        is_double |= !std::isdigit((unsigned char)rest[length]) && !(length == 0 && rest[length] == '-');
+        ++length;
+    }
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    std::string number(rest.substr(0, length));
+    char *end = nullptr;
+    f64 value = std::strtod(number.c_str(), &end);
+    if (end != number.c_str() + number.size())
+    {
+        return 0;
+    }
+
+    rest.remove_prefix(length);
+    if (!is_double && value >= std::numeric_limits<s32>::min() && value <= std::numeric_limits<s32>::max())
+    {
+        literal = JSONValue((s32)value);
+    }
+    else
+    {
+        literal = JSONValue(value);
+    }
+
+    return 1;
+}
+
+template<typename T>
+b8 JSONPath::Matches(Compare compare, const T& lhs, const T& rhs)
+{
+    switch (compare)
+    {
+        case Compare::EQ: return lhs == rhs;
+        case Compare::NE: return lhs != rhs;
+        case Compare::LT: return lhs < rhs;
+        case Compare::LE: return lhs <= rhs;
+        case Compare::GT: return lhs > rhs;
+        case Compare::GE: return lhs >= rhs;
+        case Compare::EXISTS: return 1;
+    }
+
+    return 0;
+}
+
+void JSONPath::SkipSpaces(std::string_view& rest)
+{
+    while (!rest.empty() && std::isspace((unsigned char)rest[0]))
+    {
+        rest.remove_prefix(1);
+    }
+}
+
+} // namespace JSORON
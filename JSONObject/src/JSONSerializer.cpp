@@ -0,0 +1,412 @@
+/* ------------------------------------------*/
+/* Filename: JSONSerializer.cpp              */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+
+#include "JSONSerializer.h"
+#include "NumberFormat.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    /**
+     * NOTE(19.10.26): 0 for bytes that are copied as is, otherwise the character that
+     * follows the backslash. control characters without a short escape get 'u'.
+     */
+    struct EscapeTable
+    {
+        char escape[256];
+
+        constexpr EscapeTable() : escape()
+        {
+            for (u32 c = 0; c < 0x20; ++c)
+            {
+                escape[c] = 'u';
+            }
+            escape[(u8)'\b'] = 'b';
+            escape[(u8)'\f'] = 'f';
+            escape[(u8)'\n'] = 'n';
+            escape[(u8)'\r'] = 'r';
+            escape[(u8)'\t'] = 't';
+            escape[(u8)'"'] = '"';
+            escape[(u8)'\\'] = '\\';
+        }
+    };
+
+    constexpr EscapeTable escape_table;
+
+    const u64 pretty_indent_max = 64;
+    const char pretty_indent[pretty_indent_max] = {
+        '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t',
+        '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t',
+        '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t',
+        '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t'
+    };
+
+    b8 WriteAll(s32 fd, const char *src, u64 n)
+    {
+        while (n > 0)
+        {
+            ssize_t written = write(fd, src, n);
+            if (written < 0)
+            {
+                return 0;
+            }
+            src += written;
+            n -= written;
+        }
+
+        return 1;
+    }
+}
+
+JSONSerializer::JSONSerializer(Style style) : style(style), fd(-1), failed(0),
+                                              data(nullptr), size(0), capacity(0)
+{}
+
+JSONSerializer::JSONSerializer(s32 fd, Style style, u64 capacity) : style(style), fd(fd), failed(0),
+                                                                    data(nullptr), size(0),
+                                                                    capacity(capacity)
+{
+    data = static_cast<char*>(std::malloc(capacity));
+    if (!data)
+    {
+        throw std::bad_alloc();
+    }
+}
+
+JSONSerializer::~JSONSerializer()
+{
+    Flush();
+    std::free(data);
+}
+
+void JSONSerializer::Write(const JSONObject& obj)
+{
+    WriteObject(obj, 0);
+}
+
+void JSONSerializer::Write(const JSONObject::JSONValue& value)
+{
+    WriteValue(value, 0);
+}
+
+b8 JSONSerializer::Flush()
+{
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    if (size > 0 && !failed)
+    {
+        failed = !WriteAll(fd, data, size);
+    }
+    size = 0;
+
+    return !failed;
+}
+
+char* JSONSerializer::Reserve(u64 n)
+{
+    if (size + n <= capacity)
+    {
+        return data + size;
+    }
+
+    if (fd >= 0)
+    {
+        Flush();
+        if (n <= capacity)
+        {
+            return data;
+        }
+    }
+
+    u64 new_capacity = capacity ? capacity : 256;
+    while (new_capacity < size + n)
+    {
+        new_capacity *= 2;
+    }
+
+    char *new_data = static_cast<char*>(std::realloc(data, new_capacity));
+    if (!new_data)
+    {
+        throw std::bad_alloc();
+    }
+    data = new_data;
+    capacity = new_capacity;
+
+    return data + size;
+}
+
+void JSONSerializer::Append(const char *src, u64 n)
+{
+    // NOTE(19.10.26): long runs bypass the fixed fd buffer instead of growing it
+    if (fd >= 0 && n > capacity / 2)
+    {
+        Flush();
+        failed = failed || !WriteAll(fd, src, n);
+        return;
+    }
+
+    std::memcpy(Reserve(n), src, n);
+    size += n;
+}
+
+void JSONSerializer::WriteNewLine(u32 depth)
+{
+    if (style == Style::COMPACT)
+    {
+        return;
+    }
+
+    Append('\n');
+    while (depth > pretty_indent_max)
+    {
+        Append(pretty_indent, pretty_indent_max);
+        depth -= pretty_indent_max;
+    }
+    Append(pretty_indent, depth);
+}
+
+void JSONSerializer::WriteValue(const JSONObject::JSONValue& value, u32 depth)
+{
+    switch (value.type)
+    {
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+            Append("null", 4);
+        } break;
+
+        case JSONObject::ValueType::INT:
+        {
+            WriteInt(value.int_val);
+        } break;
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            WriteDouble(value.double_val);
+        } break;
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            WriteString(value.str_val);
+        } break;
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            WriteObject(*value.json_val, depth);
+        } break;
+
+        case JSONObject::ValueType::ARR:
+        {
+            WriteArray(value.json_arr, depth);
+        } break;
+    }
+}
+
+void JSONSerializer::WriteObject(const JSONObject& obj, u32 depth)
+{
+    if (obj.Size() == 0)
+    {
+        Append("{}", 2);
+        return;
+    }
+
+    Append('{');
+    b8 first = 1;
+    for (const JSONObject::Entry<const JSONValue>& member : obj)
+    {
+        if (!first)
+        {
+            Append(',');
+        }
+        first = 0;
+
+        WriteNewLine(depth + 1);
+        WriteString(member.key);
+        if (style == Style::PRETTY)
+        {
+            Append(": ", 2);
+        }
+        else
+        {
+            Append(':');
+        }
+        WriteValue(member.value, depth + 1);
+    }
+    WriteNewLine(depth);
+    Append('}');
+}
+
+void JSONSerializer::WriteArray(const JSONObject::JSONArray& arr, u32 depth)
+{
+    if (arr.Size() == 0)
+    {
+        Append("[]", 2);
+        return;
+    }
+
+    Append('[');
+    switch (arr.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            b8 first = 1;
+            for (s32 num : arr.Ints())
+            {
+                if (!first)
+                {
+                    Append(',');
+                }
+                first = 0;
+
+                WriteNewLine(depth + 1);
+                WriteInt(num);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            b8 first = 1;
+            for (f64 num : arr.Doubles())
+            {
+                if (!first)
+                {
+                    Append(',');
+                }
+                first = 0;
+
+                WriteNewLine(depth + 1);
+                WriteDouble(num);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            b8 first = 1;
+            for (const JSONObject::JSONValue& value : arr)
+            {
+                if (!first)
+                {
+                    Append(',');
+                }
+                first = 0;
+
+                WriteNewLine(depth + 1);
+                WriteValue(value, depth + 1);
+            }
+        } break;
+
+        // NOTE(19.10.26): rows are written straight from the columns, like WriteObject
+        // would write the objects they stand for
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            Span<const JSONObject::JSONArray::TableColumn> columns = arr.Columns();
+            for (u64 row = 0; row < arr.Size(); ++row)
+            {
+                if (row)
+                {
+                    Append(',');
+                }
+
+                WriteNewLine(depth + 1);
+                Append('{');
+                b8 first = 1;
+                for (const JSONObject::JSONArray::TableColumn& column : columns)
+                {
+                    if (!first)
+                    {
+                        Append(',');
+                    }
+                    first = 0;
+
+                    WriteNewLine(depth + 2);
+                    WriteString(column.key);
+                    if (style == Style::PRETTY)
+                    {
+                        Append(": ", 2);
+                    }
+                    else
+                    {
+                        Append(':');
+                    }
+                    WriteValue(column.values.ValueAt(row), depth + 2);
+                }
+                WriteNewLine(depth + 1);
+                Append('}');
+            }
+        } break;
+    }
+    WriteNewLine(depth);
+    Append(']');
+}
+
+void JSONSerializer::WriteString(std::string_view str)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+
+    Append('"');
+
+    const char *run = str.data();
+    const char *end = str.data() + str.size();
+    for (const char *at = run; at < end; ++at)
+    {
+        char escape = escape_table.escape[(u8)*at];
+        if (!escape)
+        {
+            continue;
+        }
+
+        Append(run, at - run);
+        run = at + 1;
+
+        if (escape == 'u')
+        {
+            char *out = Reserve(6);
+            out[0] = '\\';
+            out[1] = 'u';
+            out[2] = '0';
+            out[3] = '0';
+            out[4] = hex_digits[(u8)*at >> 4];
+            out[5] = hex_digits[(u8)*at & 0xf];
+            size += 6;
+        }
+        else
+        {
+            char *out = Reserve(2);
+            out[0] = '\\';
+            out[1] = escape;
+            size += 2;
+        }
+    }
+    Append(run, end - run);
+
+    Append('"');
+}
+
+void JSONSerializer::WriteInt(s64 num)
+{
+    char *out = Reserve(max_int_chars);
+    size = FormatInt(out, num) - data;
+}
+
+void JSONSerializer::WriteDouble(f64 num)
+{
+    char *out = Reserve(max_double_chars);
+    size = FormatDouble(out, num) - data;
+}
+
+} // namespace JSORON
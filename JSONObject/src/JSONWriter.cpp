@@ -0,0 +1,218 @@
+/* ------------------------------------------*/
+/* Filename: JSONWriter.cpp                  */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include "JSONWriter.h"
+
+namespace JSORON
+{
+
+JSONWriter::JSONWriter(Style style) : out(style), failed(0), has_root(0), depth(0)
+{}
+
+JSONWriter::JSONWriter(s32 fd, Style style, u64 capacity) : out(fd, style, capacity), failed(0),
+                                                            has_root(0), depth(0)
+{}
+
+b8 JSONWriter::BeginValue()
+{
+    if (failed)
+    {
+        return 0;
+    }
+
+    if (depth == 0)
+    {
+        if (has_root)
+        {
+            return Fail();
+        }
+        has_root = 1;
+        return 1;
+    }
+
+    u8& frame = frames[depth - 1];
+    if (frame & IN_OBJECT)
+    {
+        if (!(frame & AFTER_KEY))
+        {
+            return Fail();
+        }
+        frame &= ~AFTER_KEY;
+        return 1;
+    }
+
+    if (frame & HAS_MEMBERS)
+    {
+        out.Append(',');
+    }
+    frame |= HAS_MEMBERS;
+    out.WriteNewLine(depth);
+
+    return 1;
+}
+
+b8 JSONWriter::Begin(char open, u8 flags)
+{
+    if (depth == max_depth)
+    {
+        return Fail();
+    }
+
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.Append(open);
+    frames[depth] = flags;
+    ++depth;
+
+    return 1;
+}
+
+b8 JSONWriter::End(char close, u8 flags)
+{
+    if (failed || depth == 0)
+    {
+        return Fail();
+    }
+
+    u8 frame = frames[depth - 1];
+    if ((frame & IN_OBJECT) != flags || (frame & AFTER_KEY))
+    {
+        return Fail();
+    }
+
+    --depth;
+    if (frame & HAS_MEMBERS)
+    {
+        out.WriteNewLine(depth);
+    }
+    out.Append(close);
+
+    return 1;
+}
+
+b8 JSONWriter::BeginObject()
+{
+    return Begin('{', IN_OBJECT);
+}
+
+b8 JSONWriter::EndObject()
+{
+    return End('}', IN_OBJECT);
+}
+
+b8 JSONWriter::BeginArray()
+{
+    return Begin('[', 0);
+}
+
+b8 JSONWriter::EndArray()
+{
+    return End(']', 0);
+}
+
+b8 JSONWriter::Key(std::string_view key)
+{
+    if (failed || depth == 0)
+    {
+        return Fail();
+    }
+
+    u8& frame = frames[depth - 1];
+    if (!(frame & IN_OBJECT) || (frame & AFTER_KEY))
+    {
+        return Fail();
+    }
+
+    if (frame & HAS_MEMBERS)
+    {
+        out.Append(',');
+    }
+    frame |= HAS_MEMBERS | AFTER_KEY;
+
+    out.WriteNewLine(depth);
+    out.WriteString(key);
+    if (out.style == Style::PRETTY)
+    {
+        out.Append(": ", 2);
+    }
+    else
+    {
+        out.Append(':');
+    }
+
+    return 1;
+}
+
+b8 JSONWriter::Null()
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.Append("null", 4);
+    return 1;
+}
+
+b8 JSONWriter::Int(s64 num)
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.WriteInt(num);
+    return 1;
+}
+
+b8 JSONWriter::Double(f64 num)
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.WriteDouble(num);
+    return 1;
+}
+
+b8 JSONWriter::String(std::string_view str)
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.WriteString(str);
+    return 1;
+}
+
+b8 JSONWriter::Value(const JSONObject::JSONValue& value)
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.WriteValue(value, depth);
+    return 1;
+}
+
+b8 JSONWriter::Value(const JSONObject& obj)
+{
+    if (!BeginValue())
+    {
+        return 0;
+    }
+
+    out.WriteObject(obj, depth);
+    return 1;
+}
+
+} // namespace JSORON
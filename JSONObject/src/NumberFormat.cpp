@@ -0,0 +1,129 @@
+/* ------------------------------------------*/
+/* Filename: NumberFormat.cpp                */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "NumberFormat.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    const char digit_pairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    const u64 powers_of_10[] = {
+        1ull,
+        10ull,
+        100ull,
+        1000ull,
+        10000ull,
+        100000ull,
+        1000000ull,
+        10000000ull,
+        100000000ull,
+        1000000000ull,
+        10000000000ull,
+        100000000000ull,
+        1000000000000ull,
+        10000000000000ull,
+        100000000000000ull,
+        1000000000000000ull,
+        10000000000000000ull,
+        100000000000000000ull,
+        1000000000000000000ull,
+        10000000000000000000ull
+    };
+
+    u32 CountDigits(u64 num)
+    {
+        // NOTE(19.10.26): bit width * 1233 / 4096 approximates log10, off by at most one.
+        // or-ing in 1 makes 0 count as one digit without a branch
+        num |= 1;
+        u32 bits = 64 - __builtin_clzll(num);
+        u32 digits = (bits * 1233) >> 12;
+
+        return digits + (num >= powers_of_10[digits]);
+    }
+}
+
+char* FormatUInt(char *out, u64 num)
+{
+    u32 num_digits = CountDigits(num);
+    char *at = out + num_digits;
+
+    while (num >= 100)
+    {
+        u64 pair = (num % 100) * 2;
+        num /= 100;
+        at -= 2;
+        at[0] = digit_pairs[pair];
+        at[1] = digit_pairs[pair + 1];
+    }
+
+    if (num >= 10)
+    {
+        at -= 2;
+        at[0] = digit_pairs[num * 2];
+        at[1] = digit_pairs[num * 2 + 1];
+    }
+    else
+    {
+        *--at = '0' + num;
+    }
+
+    return out + num_digits;
+}
+
+char* FormatInt(char *out, s64 num)
+{
+    u64 magnitude = (u64)num;
+    if (num < 0)
+    {
+        *out++ = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    return FormatUInt(out, magnitude);
+}
+
+char* FormatDouble(char *out, f64 num)
+{
+    if (!std::isfinite(num))
+    {
+        std::memcpy(out, "null", 4);
+        return out + 4;
+    }
+
+    // NOTE(19.10.26): to_chars without a precision is the shortest round trip form (ryu)
+    char *end = std::to_chars(out, out + max_double_chars - 2, num).ptr;
+
+    for (char *at = out; at < end; ++at)
+    {
+        if (*at == '.' || *at == 'e')
+        {
+            return end;
+        }
+    }
+
+    end[0] = '.';
+    end[1] = '0';
+    return end + 2;
+}
+
+} // namespace JSORON
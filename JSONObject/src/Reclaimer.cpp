@@ -0,0 +1,259 @@
+/* ------------------------------------------*/
+/* Filename: Reclaimer.cpp                   */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+
+#include "Reclaimer.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    u64 StringBytes(const std::string& str)
+    {
+        // NOTE(19.10.26): a string inside its small buffer has no allocation to free
+        const char *self = reinterpret_cast<const char*>(&str);
+        b8 is_small = str.data() >= self && str.data() < self + sizeof(std::string);
+        return is_small ? 0 : str.capacity() + 1;
+    }
+}
+
+Reclaimer::Reclaimer(u64 max_pending) : max_pending(max_pending), pending_objects(), pending_arrays(), 
+                                         stats(), busy(0), stopping(0)
+{
+    pending_objects.reserve(max_pending);
+    pending_arrays.reserve(max_pending);
+    worker = std::thread(&Reclaimer::Run, this);
+}
+
+Reclaimer::~Reclaimer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = 1;
+    }
+    work.notify_one();
+    worker.join();
+}
+
+void Reclaimer::Drop(JSONObject&& doc)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (NumPending() >= max_pending)
+    {
+        ++stats.documents_inline;
+        lock.unlock();
+
+        JSONObject dropped(std::move(doc));
+        return;
+    }
+
+    pending_objects.push_back(std::move(doc));
+    ++stats.documents_queued;
+    stats.peak_pending = std::max(stats.peak_pending, NumPending());
+    lock.unlock();
+
+    work.notify_one();
+}
+
+void Reclaimer::Drop(JSONObject::JSONArray&& arr)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (NumPending() >= max_pending)
+    {
+        ++stats.documents_inline;
+        lock.unlock();
+
+        JSONObject::JSONArray dropped(std::move(arr));
+        return;
+    }
+
+    pending_arrays.push_back(std::move(arr));
+    ++stats.documents_queued;
+    stats.peak_pending = std::max(stats.peak_pending, NumPending());
+    lock.unlock();
+
+    work.notify_one();
+}
+
+void Reclaimer::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return NumPending() == 0 && !busy; });
+}
+
+Reclaimer::Stats Reclaimer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void Reclaimer::Run()
+{
+#ifdef SCHED_IDLE
+    // NOTE(19.10.26): freeing can wait for idle cpu time, the threads that drop documents
+    // must not be preempted by it
+    sched_param param = {};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif /* SCHED_IDLE */
+
+    // NOTE(19.10.26): the batches swap with the queues, capacity goes back and forth
+    // and neither side allocates
+    std::vector<JSONObject> batch_objects;
+    std::vector<JSONObject::JSONArray> batch_arrays;
+    batch_objects.reserve(max_pending);
+    batch_arrays.reserve(max_pending);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        work.wait(lock, [this]() { return stopping || NumPending() > 0; });
+        if (NumPending() == 0)
+        {
+            break;
+        }
+
+        batch_objects.swap(pending_objects);
+        batch_arrays.swap(pending_arrays);
+        busy = 1;
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        u64 batch_bytes = 0;
+        for (const JSONObject& obj : batch_objects)
+        {
+            batch_bytes += MeasureObject(obj);
+        }
+        for (const JSONObject::JSONArray& arr : batch_arrays)
+        {
+            batch_bytes += MeasureArray(arr);
+        }
+        u64 num_documents = batch_objects.size() + batch_arrays.size();
+        batch_objects.clear();
+        batch_arrays.clear();
+        std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        stats.documents_reclaimed += num_documents;
+        stats.bytes_reclaimed += batch_bytes;
+        stats.reclaim_seconds += elapsed.count();
+        stats.peak_batch_bytes = std::max(stats.peak_batch_bytes, batch_bytes);
+        busy = 0;
+        idle.notify_all();
+    }
+
+    idle.notify_all();
+}
+
+u64 Reclaimer::MeasureValue(const JSONObject::JSONValue& value)
+{
+    switch (value.type)
+    {
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            return StringBytes(value.str_val);
+        }
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            return sizeof(JSONObject) + MeasureObject(*value.json_val);
+        }
+
+        case JSONObject::ValueType::ARR:
+        {
+            return MeasureArray(value.json_arr);
+        }
+
+        case JSONObject::ValueType::INT:
+        case JSONObject::ValueType::DOUBLE:
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+
+    return 0;
+}
+
+u64 Reclaimer::MeasureObject(const JSONObject& obj)
+{
+    // NOTE(19.10.26): a body with another reference outlives this document
+    const JSONObject::Body *body = obj.body;
+    if (!body || body->ref_count.load(std::memory_order_relaxed) != 1)
+    {
+        return 0;
+    }
+
+    u64 num_bytes = sizeof(JSONObject::Body) + body->members.capacity() * sizeof(JSONObject::Member) +
+                    body->index.capacity() * sizeof(u32);
+    for (const JSONObject::Member& member : body->members)
+    {
+        num_bytes += StringBytes(member.key) + MeasureValue(member.value);
+    }
+
+    return num_bytes;
+}
+
+u64 Reclaimer::MeasureArray(const JSONObject::JSONArray& arr)
+{
+    const JSONObject::JSONArray::Body *body = arr.body;
+    if (!body || body->ref_count.load(std::memory_order_relaxed) != 1)
+    {
+        return 0;
+    }
+
+    u64 num_bytes = sizeof(JSONObject::JSONArray::Body);
+    switch (body->storage)
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            num_bytes += body->int_arr.capacity() * sizeof(s32);
+        } break;
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            num_bytes += body->double_arr.capacity() * sizeof(f64);
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            num_bytes += body->array.capacity() * sizeof(JSONObject::JSONValue);
+            for (const JSONObject::JSONValue& value : body->array)
+            {
+                num_bytes += MeasureValue(value);
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            num_bytes += body->columns.capacity() * sizeof(JSONObject::JSONArray::TableColumn);
+            for (const JSONObject::JSONArray::TableColumn& column : body->columns)
+            {
+                num_bytes += StringBytes(column.key) + MeasureArray(column.values);
+            }
+        } break;
+    }
+
+    const JSONObject::JSONArray::ValueArray *unpacked = body->unpacked.load(std::memory_order_relaxed);
+    if (unpacked)
+    {
+        num_bytes += unpacked->capacity() * sizeof(JSONObject::JSONValue);
+        for (const JSONObject::JSONValue& value : *unpacked)
+        {
+            num_bytes += MeasureValue(value);
+        }
+    }
+
+    return num_bytes;
+}
+
+} // namespace JSORON
@@ -0,0 +1,712 @@
+/* ------------------------------------------*/
+/* Filename: Snapshot.cpp                    */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Snapshot.h"
+
+namespace JSORON
+{
+
+namespace
+{
+    const char snapshot_magic[8] = {'J', 'S', 'O', 'R', 'S', 'N', 'A', 'P'};
+    const u32 byte_order_mark = 0x01020304;
+
+    u64 AlignUp(u64 size)
+    {
+        return (size + 7) & ~(u64)7;
+    }
+}
+
+/**************************************************************************************************
+ *
+ *  SnapshotWriter
+ *
+ **************************************************************************************************/
+
+void SnapshotWriter::Write(const JSONObject& root)
+{
+    bytes.assign(sizeof(SnapshotHeader), 0);
+    strings.clear();
+    string_offsets.clear();
+
+    u64 root_offset = Allocate(sizeof(SnapshotNode));
+    WriteObject(root, root_offset);
+
+    u64 string_table = bytes.size();
+    bytes.insert(bytes.end(), strings.begin(), strings.end());
+    bytes.resize(AlignUp(bytes.size()));
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = Snapshot::version;
+    header.byte_order = byte_order_mark;
+    header.file_size = bytes.size();
+    header.string_table = string_table;
+    header.root = root_offset;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    // NOTE(19.10.26): the views point into root, which the caller may free after Write
+    string_offsets.clear();
+}
+
+b8 SnapshotWriter::WriteToFile(const std::string& path) const
+{
+    s32 fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    const u8 *at = bytes.data();
+    u64 left = bytes.size();
+    while (left > 0)
+    {
+        ssize_t written = write(fd, at, left);
+        if (written < 0)
+        {
+            close(fd);
+            return 0;
+        }
+        at += written;
+        left -= written;
+    }
+
+    return close(fd) == 0;
+}
+
+u64 SnapshotWriter::Allocate(u64 size)
+{
+    u64 offset = bytes.size();
+    bytes.resize(offset + AlignUp(size));
+
+    return offset;
+}
+
+u64 SnapshotWriter::InternString(std::string_view str)
+{
+    auto found = string_offsets.find(str);
+    if (found != string_offsets.end())
+    {
+        return found->second;
+    }
+
+    u64 offset = strings.size();
+    strings.insert(strings.end(), str.begin(), str.end());
+    string_offsets.emplace(str, offset);
+
+    return offset;
+}
+
+void SnapshotWriter::StoreNode(u64 node_offset, const SnapshotNode& node)
+{
+    std::memcpy(bytes.data() + node_offset, &node, sizeof(node));
+}
+
+void SnapshotWriter::WriteValue(const JSONObject::JSONValue& value, u64 node_offset)
+{
+    SnapshotNode node = {};
+    node.type = (u8)value.type;
+
+    switch (value.type)
+    {
+        case JSONObject::ValueType::INT:
+        {
+            node.payload = (u64)(s64)value.int_val;
+        } break;
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            std::memcpy(&node.payload, &value.double_val, sizeof(node.payload));
+        } break;
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            node.type = (u8)JSONObject::ValueType::STR;
+            node.size = value.str_val.size();
+            node.payload = InternString(value.str_val);
+        } break;
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            WriteObject(*value.json_val, node_offset);
+            return;
+        }
+
+        case JSONObject::ValueType::ARR:
+        {
+            WriteArray(value.json_arr, node_offset);
+            return;
+        }
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NULL_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+            node.type = (u8)JSONObject::ValueType::NULL_TYPE;
+        } break;
+    }
+
+    StoreNode(node_offset, node);
+}
+
+void SnapshotWriter::WriteObject(const JSONObject& obj, u64 node_offset)
+{
+    std::vector<const JSONObject::Member*> members;
+    members.reserve(obj.Read().Size());
+    for (const JSONObject::Member& member : obj.Read().members)
+    {
+        if (!member.IsRemoved())
+        {
+            members.push_back(&member);
+        }
+    }
+
+    u64 num_members = members.size();
+    u64 table = AllocateMembers(num_members);
+    std::vector<u64> hashes(num_members);
+    for (u64 slot = 0; slot < num_members; ++slot)
+    {
+        const JSONObject::Member& member = *members[slot];
+        u64 member_offset = StoreMember(table, slot, member.hash, member.key);
+        WriteValue(member.value, member_offset + offsetof(SnapshotMember, value));
+        hashes[slot] = member.hash;
+    }
+
+    StoreObject(node_offset, table, hashes);
+}
+
+void SnapshotWriter::WriteRow(const JSONObject::JSONArray& arr, u64 row, u64 node_offset)
+{
+    Span<const JSONObject::JSONArray::TableColumn> columns = arr.Columns();
+
+    u64 table = AllocateMembers(columns.Size());
+    std::vector<u64> hashes(columns.Size());
+    for (u64 slot = 0; slot < columns.Size(); ++slot)
+    {
+        const JSONObject::JSONArray::TableColumn& column = columns[slot];
+        u64 member_offset = StoreMember(table, slot, column.hash, column.key);
+        WriteElement(column.values, row, member_offset + offsetof(SnapshotMember, value));
+        hashes[slot] = column.hash;
+    }
+
+    StoreObject(node_offset, table, hashes);
+}
+
+void SnapshotWriter::WriteElement(const JSONObject::JSONArray& arr, u64 index, u64 node_offset)
+{
+    // NOTE(19.10.26): strings and keys are interned as views, so elements are written
+    // from where they live in the document and never from a temporary copy. packed
+    // elements are scalars and rows are written from the columns
+    switch (arr.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            WriteValue(arr.ValueAt(index), node_offset);
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            WriteValue(arr.At(index), node_offset);
+        } break;
+
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            WriteRow(arr, index, node_offset);
+        } break;
+    }
+}
+
+u64 SnapshotWriter::AllocateMembers(u64 num_members)
+{
+    b8 has_index = num_members > Snapshot::linear_lookup_max;
+    return Allocate(num_members * sizeof(SnapshotMember) + (has_index ? num_members * sizeof(u32) : 0));
+}
+
+u64 SnapshotWriter::StoreMember(u64 table, u64 slot, u64 hash, std::string_view key)
+{
+    u64 member_offset = table + slot * sizeof(SnapshotMember);
+
+    SnapshotMember snapshot_member = {};
+    snapshot_member.hash = hash;
+    snapshot_member.key_offset = InternString(key);
+    snapshot_member.key_size = key.size();
+    std::memcpy(bytes.data() + member_offset, &snapshot_member, sizeof(snapshot_member));
+
+    return member_offset;
+}
+
+void SnapshotWriter::StoreObject(u64 node_offset, u64 table, const std::vector<u64>& hashes)
+{
+    u64 num_members = hashes.size();
+    if (num_members > Snapshot::linear_lookup_max)
+    {
+        std::vector<u32> slots(num_members);
+        for (u32 slot = 0; slot < num_members; ++slot)
+        {
+            slots[slot] = slot;
+        }
+        std::sort(slots.begin(), slots.end(), [&hashes](u32 lhs, u32 rhs)
+        {
+            return hashes[lhs] < hashes[rhs];
+        });
+        std::memcpy(bytes.data() + table + num_members * sizeof(SnapshotMember), slots.data(),
+                    num_members * sizeof(u32));
+    }
+
+    SnapshotNode node = {};
+    node.type = (u8)JSONObject::ValueType::JSON_OBJECT;
+    node.size = num_members;
+    node.payload = table;
+    StoreNode(node_offset, node);
+}
+
+void SnapshotWriter::WriteArray(const JSONObject::JSONArray& arr, u64 node_offset)
+{
+    // NOTE(19.10.26): a TABLE array is written as an array of objects, the layout has
+    // no columns
+    SnapshotNode node = {};
+    node.type = (u8)JSONObject::ValueType::ARR;
+    node.storage = (u8)arr.GetStorage();
+    if (arr.GetStorage() == JSONObject::JSONArray::Storage::TABLE)
+    {
+        node.storage = (u8)JSONObject::JSONArray::Storage::GENERIC;
+    }
+    node.size = arr.Size();
+
+    if (arr.Size() == 0)
+    {
+        StoreNode(node_offset, node);
+        return;
+    }
+
+    switch (arr.GetStorage())
+    {
+        case JSONObject::JSONArray::Storage::INTS:
+        {
+            node.payload = Allocate(arr.Size() * sizeof(s32));
+            std::memcpy(bytes.data() + node.payload, arr.Ints().Data(), arr.Size() * sizeof(s32));
+        } break;
+
+        case JSONObject::JSONArray::Storage::DOUBLES:
+        {
+            node.payload = Allocate(arr.Size() * sizeof(f64));
+            std::memcpy(bytes.data() + node.payload, arr.Doubles().Data(), arr.Size() * sizeof(f64));
+        } break;
+
+        case JSONObject::JSONArray::Storage::GENERIC:
+        {
+            node.payload = Allocate(arr.Size() * sizeof(SnapshotNode));
+            u64 index = 0;
+            for (const JSONObject::JSONValue& value : arr)
+            {
+                WriteValue(value, node.payload + index * sizeof(SnapshotNode));
+                ++index;
+            }
+        } break;
+
+        case JSONObject::JSONArray::Storage::TABLE:
+        {
+            node.payload = Allocate(arr.Size() * sizeof(SnapshotNode));
+            for (u64 index = 0; index < arr.Size(); ++index)
+            {
+                WriteRow(arr, index, node.payload + index * sizeof(SnapshotNode));
+            }
+        } break;
+    }
+
+    StoreNode(node_offset, node);
+}
+
+/**************************************************************************************************
+ *
+ *  SnapshotValue
+ *
+ **************************************************************************************************/
+
+JSONObject::ValueType SnapshotValue::Type() const
+{
+    return node ? (JSONObject::ValueType)node->type : JSONObject::ValueType::BAD_TYPE;
+}
+
+JSONObject::JSONArray::Storage SnapshotValue::GetStorage() const
+{
+    if (Type() != JSONObject::ValueType::ARR)
+    {
+        return JSONObject::JSONArray::Storage::GENERIC;
+    }
+
+    return (JSONObject::JSONArray::Storage)node->storage;
+}
+
+s32 SnapshotValue::AsInt() const
+{
+    return Type() == JSONObject::ValueType::INT ? (s32)(s64)node->payload : 0;
+}
+
+f64 SnapshotValue::AsDouble() const
+{
+    if (Type() != JSONObject::ValueType::DOUBLE)
+    {
+        return 0;
+    }
+
+    f64 num;
+    std::memcpy(&num, &node->payload, sizeof(num));
+    return num;
+}
+
+std::string_view SnapshotValue::AsStr() const
+{
+    if (Type() != JSONObject::ValueType::STR)
+    {
+        return std::string_view();
+    }
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(base);
+    return std::string_view(reinterpret_cast<const char*>(base + header->string_table + node->payload),
+                            node->size);
+}
+
+u64 SnapshotValue::Size() const
+{
+    JSONObject::ValueType type = Type();
+    if (type != JSONObject::ValueType::JSON_OBJECT && type != JSONObject::ValueType::ARR)
+    {
+        return 0;
+    }
+
+    return node->size;
+}
+
+SnapshotValue SnapshotValue::operator[](u64 index) const
+{
+    if (Type() != JSONObject::ValueType::ARR || index >= node->size ||
+        node->storage != (u8)JSONObject::JSONArray::Storage::GENERIC)
+    {
+        return SnapshotValue();
+    }
+
+    const SnapshotNode *elements = reinterpret_cast<const SnapshotNode*>(base + node->payload);
+    return SnapshotValue(base, elements + index);
+}
+
+SnapshotValue SnapshotValue::operator[](std::string_view key) const
+{
+    return Find(key, HashKey(key));
+}
+
+SnapshotValue SnapshotValue::operator[](const Key& key) const
+{
+    return Find(key.View(), key.Hash());
+}
+
+const SnapshotMember* SnapshotValue::Members() const
+{
+    return reinterpret_cast<const SnapshotMember*>(base + node->payload);
+}
+
+std::string_view SnapshotValue::KeyAt(u64 index) const
+{
+    if (Type() != JSONObject::ValueType::JSON_OBJECT || index >= node->size)
+    {
+        return std::string_view();
+    }
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(base);
+    const SnapshotMember& member = Members()[index];
+    return std::string_view(reinterpret_cast<const char*>(base + header->string_table + member.key_offset),
+                            member.key_size);
+}
+
+SnapshotValue SnapshotValue::ValueAt(u64 index) const
+{
+    if (Type() != JSONObject::ValueType::JSON_OBJECT || index >= node->size)
+    {
+        return SnapshotValue();
+    }
+
+    return SnapshotValue(base, &Members()[index].value);
+}
+
+SnapshotValue SnapshotValue::Find(std::string_view key, u64 hash) const
+{
+    if (Type() != JSONObject::ValueType::JSON_OBJECT)
+    {
+        return SnapshotValue();
+    }
+
+    const SnapshotMember *members = Members();
+    u64 num_members = node->size;
+
+    if (num_members <= Snapshot::linear_lookup_max)
+    {
+        for (u64 slot = 0; slot < num_members; ++slot)
+        {
+            if (members[slot].hash == hash && KeyAt(slot) == key)
+            {
+                return SnapshotValue(base, &members[slot].value);
+            }
+        }
+
+        return SnapshotValue();
+    }
+
+    const u32 *slots = reinterpret_cast<const u32*>(members + num_members);
+    const u32 *first = std::lower_bound(slots, slots + num_members, hash, [members](u32 slot, u64 hash)
+    {
+        return members[slot].hash < hash;
+    });
+
+    for (const u32 *at = first; at < slots + num_members && members[*at].hash == hash; ++at)
+    {
+        if (KeyAt(*at) == key)
+        {
+            return SnapshotValue(base, &members[*at].value);
+        }
+    }
+
+    return SnapshotValue();
+}
+
+Span<const s32> SnapshotValue::Ints() const
+{
+    if (GetStorage() != JSONObject::JSONArray::Storage::INTS)
+    {
+        return Span<const s32>();
+    }
+
+    return Span<const s32>(reinterpret_cast<const s32*>(base + node->payload), node->size);
+}
+
+Span<const f64> SnapshotValue::Doubles() const
+{
+    if (GetStorage() != JSONObject::JSONArray::Storage::DOUBLES)
+    {
+        return Span<const f64>();
+    }
+
+    return Span<const f64>(reinterpret_cast<const f64*>(base + node->payload), node->size);
+}
+
+JSONObject::JSONValue SnapshotValue::Materialize() const
+{
+    switch (Type())
+    {
+        case JSONObject::ValueType::INT:
+        {
+            return JSONObject::JSONValue(AsInt());
+        }
+
+        case JSONObject::ValueType::DOUBLE:
+        {
+            return JSONObject::JSONValue(AsDouble());
+        }
+
+        case JSONObject::ValueType::KEY:
+        case JSONObject::ValueType::STR:
+        {
+            return JSONObject::JSONValue(std::string(AsStr()));
+        }
+
+        case JSONObject::ValueType::JSON_OBJECT:
+        {
+            JSONObject obj;
+            for (u64 slot = 0; slot < node->size; ++slot)
+            {
+                obj.Put(std::string(KeyAt(slot)), ValueAt(slot).Materialize());
+            }
+            return JSONObject::JSONValue(std::move(obj));
+        }
+
+        case JSONObject::ValueType::ARR:
+        {
+            JSONObject::JSONArray arr(GetStorage());
+            arr.Reserve(node->size);
+            switch (GetStorage())
+            {
+                case JSONObject::JSONArray::Storage::INTS:
+                {
+                    for (s32 num : Ints())
+                    {
+                        arr.PushBack(num);
+                    }
+                } break;
+
+                case JSONObject::JSONArray::Storage::DOUBLES:
+                {
+                    for (f64 num : Doubles())
+                    {
+                        arr.PushBack(num);
+                    }
+                } break;
+
+                case JSONObject::JSONArray::Storage::GENERIC:
+                case JSONObject::JSONArray::Storage::TABLE:
+                {
+                    for (u64 index = 0; index < node->size; ++index)
+                    {
+                        arr.PushBack((*this)[index].Materialize());
+                    }
+                } break;
+            }
+            return JSONObject::JSONValue(std::move(arr));
+        }
+
+        case JSONObject::ValueType::NULL_TYPE:
+        {
+            return JSONObject::JSONValue();
+        }
+
+        case JSONObject::ValueType::BAD_TYPE:
+        case JSONObject::ValueType::NUM_JSON_TYPES:
+        {
+        } break;
+    }
+
+    return JSONObject::JSONValue(JSONObject::ValueType::BAD_TYPE);
+}
+
+/**************************************************************************************************
+ *
+ *  Snapshot
+ *
+ **************************************************************************************************/
+
+Snapshot::~Snapshot()
+{
+    Close();
+}
+
+b8 Snapshot::Open(const std::string& path)
+{
+    Close();
+
+    s32 fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || (u64)file_stat.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return 0;
+    }
+
+    void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    data = static_cast<const u8*>(mapping);
+    size = file_stat.st_size;
+    mapped = 1;
+
+    if (!Validate())
+    {
+        Close();
+        return 0;
+    }
+
+    return 1;
+}
+
+b8 Snapshot::Load(const u8 *snapshot_data, u64 snapshot_size)
+{
+    Close();
+
+    data = snapshot_data;
+    size = snapshot_size;
+    if (size < sizeof(SnapshotHeader) || !Validate())
+    {
+        data = nullptr;
+        size = 0;
+        return 0;
+    }
+
+    return 1;
+}
+
+void Snapshot::Close()
+{
+    if (mapped)
+    {
+        munmap(const_cast<u8*>(data), size);
+    }
+
+    data = nullptr;
+    size = 0;
+    mapped = 0;
+}
+
+b8 Snapshot::Validate() const
+{
+    // NOTE(19.10.26): only the header is checked, the nodes are trusted as written
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(data);
+
+    return std::memcmp(header->magic, snapshot_magic, sizeof(snapshot_magic)) == 0 &&
+           header->version == version &&
+           header->byte_order == byte_order_mark &&
+           header->file_size == size &&
+           header->string_table <= size &&
+           header->root + sizeof(SnapshotNode) <= header->string_table &&
+           header->root % 8 == 0;
+}
+
+SnapshotValue Snapshot::Root() const
+{
+    if (!data)
+    {
+        return SnapshotValue();
+    }
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(data);
+    return SnapshotValue(data, reinterpret_cast<const SnapshotNode*>(data + header->root));
+}
+
+/**************************************************************************************************
+ *
+ *  FrozenDocument
+ *
+ **************************************************************************************************/
+
+FrozenDocument FrozenDocument::Freeze(const JSONObject& root)
+{
+    SnapshotWriter writer;
+    writer.Write(root);
+
+    FrozenDocument frozen;
+    frozen.bytes = std::move(writer.bytes);
+    frozen.bytes.shrink_to_fit();
+    return frozen;
+}
+
+SnapshotValue FrozenDocument::Root() const
+{
+    if (bytes.empty())
+    {
+        return SnapshotValue();
+    }
+
+    const u8 *data = bytes.data();
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(data);
+    return SnapshotValue(data, reinterpret_cast<const SnapshotNode*>(data + header->root));
+}
+
+} // namespace JSORON
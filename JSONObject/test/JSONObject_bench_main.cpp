@@ -0,0 +1,1145 @@
+/* ------------------------------------------*/ 
+/* Filename: JSONObject_bench_main.cpp       */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */ 
+/* ------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "Aggregate.h"
+#include "ConcurrentObject.h"
+#include "JSONObject.h"
+#include "JSONPatch.h"
+#include "JSONPath.h"
+#include "JSONSerializer.h"
+#include "JSONWriter.h"
+#include "NumberFormat.h"
+#include "Reclaimer.h"
+#include "Snapshot.h"
+
+using namespace JSORON;
+
+typedef std::chrono::steady_clock Clock;
+
+static f64 NanosecondsSince(Clock::time_point start, u64 num_ops)
+{
+    std::chrono::duration<f64, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / num_ops;
+}
+
+static void PrintResult(const char *name, f64 ns_per_op, f64 checksum)
+{
+    std::cout << name << ": " << ns_per_op << " ns/op (checksum " << checksum << ")\n";
+}
+
+JSONArray CreatePairs(u64 num_pairs)
+{
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<f64> x_dist(-180.0, 180.0);
+    std::uniform_real_distribution<f64> y_dist(-90.0, 90.0);
+
+    JSONArray pairs;
+    pairs.Reserve(num_pairs);
+    for (u64 index = 0; index < num_pairs; ++index)
+    {
+        JSONObject pair;
+        pair.Put("x0", x_dist(rng));
+        pair.Put("y0", y_dist(rng));
+        pair.Put("x1", x_dist(rng));
+        pair.Put("y1", y_dist(rng));
+        pairs.PushBack(JSONValue(std::move(pair)));
+    }
+
+    return pairs;
+}
+
+static constexpr Key x0_key = "x0"_key;
+static constexpr Key y0_key = "y0"_key;
+static constexpr Key x1_key = "x1"_key;
+static constexpr Key y1_key = "y1"_key;
+
+void BenchKeyLookup(const JSONArray& pairs, u64 repeats)
+{
+    u64 num_lookups = pairs.Size() * repeats * 4;
+
+    f64 sum = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < pairs.Size(); ++index)
+        {
+            const JSONObject& pair = pairs.At(index);
+            sum += (f64)pair[std::string("x0")] + (f64)pair[std::string("y0")] + 
+                   (f64)pair[std::string("x1")] + (f64)pair[std::string("y1")];
+        }
+    }
+    PrintResult("operator[](std::string)", NanosecondsSince(start, num_lookups), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < pairs.Size(); ++index)
+        {
+            const JSONObject& pair = pairs.At(index);
+            sum += (f64)pair["x0"] + (f64)pair["y0"] + (f64)pair["x1"] + (f64)pair["y1"];
+        }
+    }
+    PrintResult("operator[](string_view)", NanosecondsSince(start, num_lookups), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < pairs.Size(); ++index)
+        {
+            const JSONObject& pair = pairs.At(index);
+            sum += (f64)pair[x0_key] + (f64)pair[y0_key] + (f64)pair[x1_key] + (f64)pair[y1_key];
+        }
+    }
+    PrintResult("operator[](const Key&)", NanosecondsSince(start, num_lookups), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < pairs.Size(); ++index)
+        {
+            const JSONObject& pair = pairs.At(index);
+            sum += (f64)pair.Get<x0_key>() + (f64)pair.Get<y0_key>() + 
+                   (f64)pair.Get<x1_key>() + (f64)pair.Get<y1_key>();
+        }
+    }
+    PrintResult("Get<K>()", NanosecondsSince(start, num_lookups), sum);
+}
+
+static void PrintThroughput(const char *name, Clock::time_point start, u64 num_bytes)
+{
+    std::chrono::duration<f64> elapsed = Clock::now() - start;
+    std::cout << name << ": " << num_bytes / elapsed.count() / (1024 * 1024) << " MB/s (" 
+              << num_bytes << " bytes)\n";
+}
+
+void BenchSerialize(const JSONArray& pairs, u64 repeats)
+{
+    JSONObject doc;
+    doc.Put("pairs", pairs);
+
+    u64 num_bytes = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        JSONSerializer serializer;
+        serializer.Write(doc);
+        num_bytes += serializer.View().size();
+    }
+    PrintThroughput("compact to buffer", start, num_bytes);
+    u64 compact_bytes = num_bytes;
+
+    num_bytes = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        JSONSerializer serializer(JSONSerializer::Style::PRETTY);
+        serializer.Write(doc);
+        num_bytes += serializer.View().size();
+    }
+    PrintThroughput("pretty to buffer", start, num_bytes);
+
+    s32 fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    start = Clock::now();
+    {
+        JSONSerializer serializer(fd);
+        for (u64 repeat = 0; repeat < repeats; ++repeat)
+        {
+            serializer.Write(doc);
+        }
+    }
+    PrintThroughput("compact to /dev/null", start, compact_bytes);
+    close(fd);
+}
+
+void BenchGeneratePairs(u64 num_pairs)
+{
+    s32 fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+    {
+        JSONArray pairs = CreatePairs(num_pairs);
+        JSONObject doc;
+        doc.Put("pairs", pairs);
+
+        JSONSerializer serializer(fd);
+        serializer.Write(doc);
+    }
+    PrintResult("JSONObject + JSONSerializer", NanosecondsSince(start, num_pairs), 0);
+
+    start = Clock::now();
+    {
+        std::mt19937_64 rng(2024);
+        std::uniform_real_distribution<f64> x_dist(-180.0, 180.0);
+        std::uniform_real_distribution<f64> y_dist(-90.0, 90.0);
+
+        JSONWriter writer(fd);
+        writer.BeginObject();
+        writer.Key("pairs");
+        writer.BeginArray();
+        for (u64 index = 0; index < num_pairs; ++index)
+        {
+            writer.BeginObject();
+            writer.Key("x0");
+            writer.Double(x_dist(rng));
+            writer.Key("y0");
+            writer.Double(y_dist(rng));
+            writer.Key("x1");
+            writer.Double(x_dist(rng));
+            writer.Key("y1");
+            writer.Double(y_dist(rng));
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    PrintResult("JSONWriter", NanosecondsSince(start, num_pairs), 0);
+
+    close(fd);
+}
+
+void BenchNumberFormat(u64 num_values)
+{
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<f64> coord_dist(-180.0, 180.0);
+    std::uniform_int_distribution<s64> int_dist(-1000000000, 1000000000);
+
+    std::vector<f64> doubles(num_values);
+    std::vector<s64> ints(num_values);
+    for (u64 index = 0; index < num_values; ++index)
+    {
+        doubles[index] = coord_dist(rng);
+        ints[index] = int_dist(rng);
+    }
+
+    char text[64];
+    u64 num_chars = 0;
+    Clock::time_point start = Clock::now();
+    for (f64 num : doubles)
+    {
+        num_chars += FormatDouble(text, num) - text;
+    }
+    PrintResult("FormatDouble", NanosecondsSince(start, num_values), num_chars);
+
+    num_chars = 0;
+    start = Clock::now();
+    for (f64 num : doubles)
+    {
+        num_chars += std::snprintf(text, sizeof(text), "%.17g", num);
+    }
+    PrintResult("snprintf %.17g", NanosecondsSince(start, num_values), num_chars);
+
+    num_chars = 0;
+    start = Clock::now();
+    std::ostringstream out;
+    for (f64 num : doubles)
+    {
+        out << num;
+    }
+    num_chars = out.str().size();
+    PrintResult("ostream (6 digits)", NanosecondsSince(start, num_values), num_chars);
+
+    num_chars = 0;
+    start = Clock::now();
+    for (s64 num : ints)
+    {
+        num_chars += FormatInt(text, num) - text;
+    }
+    PrintResult("FormatInt", NanosecondsSince(start, num_values), num_chars);
+
+    num_chars = 0;
+    start = Clock::now();
+    for (s64 num : ints)
+    {
+        num_chars += std::snprintf(text, sizeof(text), "%lld", (long long)num);
+    }
+    PrintResult("snprintf %lld", NanosecondsSince(start, num_values), num_chars);
+}
+
+void BenchCompare(u64 num_pairs, u64 repeats)
+{
+    JSONArray current = CreatePairs(num_pairs);
+    JSONArray previous = CreatePairs(num_pairs);
+
+    // NOTE(19.10.26): the first compare computes and caches every hash, the later
+    // ones only read the cached ones before the confirming walk
+    u64 num_equal = 0;
+    Clock::time_point start = Clock::now();
+    num_equal += current == previous;
+    PrintResult("equal, cold hashes", NanosecondsSince(start, 1), (f64)num_equal);
+
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        num_equal += current == previous;
+    }
+    PrintResult("equal, cached hashes", NanosecondsSince(start, repeats), (f64)num_equal);
+
+    // NOTE(19.10.26): a change detection round, one member changes and only the hashes
+    // on its path are recomputed
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        JSONObject& pair = current.At((repeat * 7919) % num_pairs);
+        pair["x0"] = (f64)repeat;
+        num_equal += current == previous;
+    }
+    PrintResult("one member changed", NanosecondsSince(start, repeats), (f64)num_equal);
+}
+
+void BenchDiff(u64 num_pairs, u64 repeats)
+{
+    JSONObject previous;
+    previous.Put("pairs", CreatePairs(num_pairs));
+    JSONObject separate_base;
+    separate_base.Put("pairs", CreatePairs(num_pairs));
+
+    // NOTE(19.10.26): every round changes one pair of a fresh version. a version made by
+    // copy and mutate shares every other pair with previous, a version built separately
+    // shares nothing and the diff goes by hashes. only Diff and Apply are timed
+    f64 derived_ns = 0;
+    f64 separate_ns = 0;
+    f64 apply_ns = 0;
+    u64 num_ops = 0;
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        u64 changed = (repeat * 7919) % num_pairs;
+
+        JSONObject derived = previous;
+        JSONArray& derived_pairs = derived["pairs"];
+        ((JSONObject&)derived_pairs.At(changed))["x0"] = (f64)repeat;
+
+        JSONObject separate = separate_base;
+        JSONArray& separate_pairs = separate["pairs"];
+        ((JSONObject&)separate_pairs.At(changed))["x0"] = (f64)repeat;
+
+        Clock::time_point start = Clock::now();
+        JSONArray patch = JSONPatch::Diff(previous, derived);
+        derived_ns += NanosecondsSince(start, 1);
+        num_ops += patch.Size();
+
+        start = Clock::now();
+        num_ops += JSONPatch::Diff(previous, separate).Size();
+        separate_ns += NanosecondsSince(start, 1);
+
+        JSONObject replica = previous;
+        start = Clock::now();
+        num_ops += JSONPatch::Apply(replica, patch);
+        apply_ns += NanosecondsSince(start, 1);
+    }
+
+    PrintResult("Diff, derived version", derived_ns / repeats, (f64)num_ops);
+    PrintResult("Diff, separate version", separate_ns / repeats, (f64)num_ops);
+    PrintResult("Apply, one op", apply_ns / repeats, (f64)num_ops);
+}
+
+void BenchRemoveChurn(u64 window_size, u64 num_rounds, u64 ops_per_round)
+{
+    // NOTE(19.10.26): a cache keeping the newest window_size keys, every insertion
+    // evicts the oldest key. the cost per round must not grow with the rounds
+    std::vector<std::string> keys(window_size + ops_per_round * num_rounds);
+    for (u64 index = 0; index < keys.size(); ++index)
+    {
+        keys[index] = "key" + std::to_string(index);
+    }
+
+    JSONObject cache;
+    for (u64 index = 0; index < window_size; ++index)
+    {
+        cache.Put(keys[index], (s32)index);
+    }
+
+    u64 next = window_size;
+    for (u64 round = 0; round < num_rounds; ++round)
+    {
+        Clock::time_point start = Clock::now();
+        for (u64 op = 0; op < ops_per_round; ++op, ++next)
+        {
+            cache.Put(keys[next], (s32)next);
+            cache.Remove(keys[next - window_size]);
+        }
+
+        std::string name = "Put + Remove, round " + std::to_string(round);
+        PrintResult(name.c_str(), NanosecondsSince(start, ops_per_round), 
+                    (f64)(s32)cache[keys[next - 1]]);
+    }
+}
+
+void BenchMemberWalk(u64 num_members, u64 repeats)
+{
+    std::vector<std::string> keys(num_members);
+    JSONObject obj;
+    for (u64 index = 0; index < num_members; ++index)
+    {
+        keys[index] = "member" + std::to_string(index);
+        obj.Put(keys[index], (s32)index);
+    }
+    const JSONObject& read_obj = obj;
+
+    // NOTE(19.10.26): the old way to walk an object, a lookup per known key
+    f64 sum = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (const std::string& key : keys)
+        {
+            sum += (s32)read_obj[key];
+        }
+    }
+    PrintResult("lookup per key", NanosecondsSince(start, num_members * repeats), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (auto [key, value] : read_obj)
+        {
+            sum += value.int_val;
+        }
+    }
+    PrintResult("iterator", NanosecondsSince(start, num_members * repeats), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        read_obj.ForEachMember([&sum](std::string_view key, const auto& value)
+        {
+            if constexpr (std::is_same_v<std::decay_t<decltype(value)>, s32>)
+            {
+                sum += value;
+            }
+        });
+    }
+    PrintResult("ForEachMember", NanosecondsSince(start, num_members * repeats), sum);
+}
+
+void BenchDeferredDrop(u64 num_pairs, u64 num_docs)
+{
+    // NOTE(19.10.26): the caller's latency for dropping a document, inline versus
+    // handing it to the reclaimer
+    f64 inline_ns = 0;
+    for (u64 index = 0; index < num_docs; ++index)
+    {
+        JSONObject doc;
+        doc.Put("pairs", CreatePairs(num_pairs));
+
+        Clock::time_point start = Clock::now();
+        doc = JSONObject();
+        inline_ns += NanosecondsSince(start, 1);
+    }
+    PrintResult("drop inline", inline_ns / num_docs, 0);
+
+    Reclaimer reclaimer;
+    f64 deferred_ns = 0;
+    for (u64 index = 0; index < num_docs; ++index)
+    {
+        JSONObject doc;
+        doc.Put("pairs", CreatePairs(num_pairs));
+
+        Clock::time_point start = Clock::now();
+        reclaimer.Drop(std::move(doc));
+        deferred_ns += NanosecondsSince(start, 1);
+    }
+    reclaimer.Flush();
+
+    Reclaimer::Stats stats = reclaimer.GetStats();
+    PrintResult("drop deferred", deferred_ns / num_docs, (f64)stats.documents_reclaimed);
+    std::cout << "reclaimer: " << stats.bytes_reclaimed / (stats.reclaim_seconds * 1024 * 1024) << " MB/s, "
+              << "peak batch " << stats.peak_batch_bytes / (1024 * 1024) << " MB, "
+              << "peak pending " << stats.peak_pending << " documents\n";
+}
+
+void BenchFrozenReads(const JSONArray& pairs, u64 repeats, u64 max_threads)
+{
+    JSONObject doc;
+    doc.Put("pairs", pairs);
+    FrozenDocument frozen = FrozenDocument::Freeze(doc);
+
+    // NOTE(19.10.26): every thread does the same lookups on the one frozen document,
+    // with perfect scaling the aggregate rate grows with the thread count
+    u64 lookups_per_thread = pairs.Size() * repeats * 4;
+    for (u64 num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        std::vector<f64> sums(num_threads, 0);
+        std::vector<std::thread> readers;
+
+        Clock::time_point start = Clock::now();
+        for (u64 thread = 0; thread < num_threads; ++thread)
+        {
+            readers.emplace_back([&frozen, &sums, thread, repeats]()
+            {
+                SnapshotValue frozen_pairs = frozen.Root()["pairs"];
+                u64 num_pairs = frozen_pairs.Size();
+
+                f64 sum = 0;
+                for (u64 repeat = 0; repeat < repeats; ++repeat)
+                {
+                    for (u64 index = 0; index < num_pairs; ++index)
+                    {
+                        SnapshotValue pair = frozen_pairs[index];
+                        sum += pair[x0_key].AsDouble() + pair[y0_key].AsDouble() +
+                               pair[x1_key].AsDouble() + pair[y1_key].AsDouble();
+                    }
+                }
+                sums[thread] = sum;
+            });
+        }
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+        std::chrono::duration<f64> elapsed = Clock::now() - start;
+
+        std::cout << "frozen reads, " << num_threads << " threads: "
+                  << lookups_per_thread * num_threads / (elapsed.count() * 1e6) << " M lookups/s (checksum "
+                  << sums[0] << ")\n";
+    }
+}
+
+void BenchContention(u64 num_keys, u64 ops_per_thread, u64 max_threads)
+{
+    std::vector<std::string> keys;
+    for (u64 index = 0; index < num_keys; ++index)
+    {
+        keys.push_back("key" + std::to_string(index));
+    }
+
+    // NOTE(19.10.26): every worker updates a counter and reads another one, 3 of 4 ops
+    // are updates. the baseline is one object behind one mutex
+    auto run = [&keys, ops_per_thread](u64 num_threads, auto&& update, auto&& read) -> f64
+    {
+        std::vector<std::thread> workers;
+        Clock::time_point start = Clock::now();
+        for (u64 thread = 0; thread < num_threads; ++thread)
+        {
+            workers.emplace_back([&keys, &update, &read, thread, ops_per_thread]()
+            {
+                std::mt19937_64 rng(thread);
+                for (u64 op = 0; op < ops_per_thread; ++op)
+                {
+                    const std::string& key = keys[rng() % keys.size()];
+                    if (op % 4 == 3)
+                    {
+                        read(key);
+                    }
+                    else
+                    {
+                        update(key);
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        std::chrono::duration<f64> elapsed = Clock::now() - start;
+        return ops_per_thread * num_threads / (elapsed.count() * 1e6);
+    };
+
+    auto increment = [](JSONValue& counter)
+    {
+        counter = counter.type == JSONObject::ValueType::INT ? (s32)counter + 1 : 1;
+    };
+
+    for (u64 num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        JSONObject locked;
+        std::mutex locked_mutex;
+        f64 global_rate = run(num_threads, [&](const std::string& key)
+        {
+            std::lock_guard<std::mutex> lock(locked_mutex);
+            increment(locked.Emplace(key));
+        },
+        [&](const std::string& key)
+        {
+            std::lock_guard<std::mutex> lock(locked_mutex);
+            const JSONObject& read_only = locked;
+            JSONValue value = read_only[key];
+        });
+
+        ConcurrentObject sharded;
+        f64 sharded_rate = run(num_threads, [&](const std::string& key)
+        {
+            sharded.Update(key, increment);
+        },
+        [&](const std::string& key)
+        {
+            JSONValue value;
+            sharded.Get(key, value);
+        });
+
+        std::cout << num_threads << " threads: global mutex " << global_rate << " M ops/s, sharded "
+                  << sharded_rate << " M ops/s\n";
+    }
+}
+
+void BenchTableScan(const JSONArray& pairs, u64 repeats)
+{
+    JSONArray table = pairs;
+    table.ToTable();
+    u64 num_values = pairs.Size() * repeats * 4;
+
+    f64 sum = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (const JSONValue& value : pairs)
+        {
+            const JSONObject& pair = value;
+            sum += (f64)pair.Get<x0_key>() + (f64)pair.Get<y0_key>() + 
+                   (f64)pair.Get<x1_key>() + (f64)pair.Get<y1_key>();
+        }
+    }
+    PrintResult("rows, Get<Key>", NanosecondsSince(start, num_values), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < table.Size(); ++index)
+        {
+            JSONArray::RowView row = table.Row(index);
+            sum += row[x0_key].double_val + row[y0_key].double_val + 
+                   row[x1_key].double_val + row[y1_key].double_val;
+        }
+    }
+    PrintResult("table, Row view", NanosecondsSince(start, num_values), sum);
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (const Key& key : {x0_key, y0_key, x1_key, y1_key})
+        {
+            for (f64 num : table.Column(key)->Doubles())
+            {
+                sum += num;
+            }
+        }
+    }
+    PrintResult("table, column scan", NanosecondsSince(start, num_values), sum);
+}
+
+void BenchExtractColumn(JSONArray pairs, u64 repeats)
+{
+    u64 num_values = pairs.Size() * repeats * 4;
+    std::vector<f64> columns(pairs.Size() * 4);
+    Span<f64> outs[] = {Span<f64>(columns.data(), pairs.Size()), 
+                        Span<f64>(columns.data() + pairs.Size(), pairs.Size()),
+                        Span<f64>(columns.data() + pairs.Size() * 2, pairs.Size()),
+                        Span<f64>(columns.data() + pairs.Size() * 3, pairs.Size())};
+    Key keys[] = {x0_key, y0_key, x1_key, y1_key};
+
+    // NOTE(19.10.26): the chain through JSONValue, operator[](u64) copies every pair
+    JSONValue pairs_value(pairs);
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 field = 0; field < 4; ++field)
+        {
+            std::string key(keys[field].View());
+            for (u64 index = 0; index < pairs.Size(); ++index)
+            {
+                outs[field][index] = (f64)pairs_value[index][key];
+            }
+        }
+    }
+    PrintResult("operator[] chain", NanosecondsSince(start, num_values), columns[pairs.Size() - 1]);
+
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 field = 0; field < 4; ++field)
+        {
+            pairs.ExtractColumn(keys[field], outs[field]);
+        }
+    }
+    PrintResult("ExtractColumn", NanosecondsSince(start, num_values), columns[pairs.Size() - 1]);
+
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        pairs.ExtractColumns(Span<const Key>(keys, 4), Span<const Span<f64>>(outs, 4));
+    }
+    PrintResult("ExtractColumns", NanosecondsSince(start, num_values), columns[pairs.Size() - 1]);
+
+    pairs.ToTable();
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        pairs.ExtractColumns(Span<const Key>(keys, 4), Span<const Span<f64>>(outs, 4));
+    }
+    PrintResult("ExtractColumns, table", NanosecondsSince(start, num_values), columns[pairs.Size() - 1]);
+}
+
+void BenchJSONPath(const JSONArray& pairs, u64 repeats)
+{
+    JSONObject doc;
+    doc.Put("pairs", JSONValue(pairs));
+    JSONObject table_doc;
+    table_doc.Put("pairs", JSONValue(pairs));
+    table_doc["pairs"].json_arr.ToTable();
+    const JSONArray& rows = doc["pairs"].json_arr;
+    u64 num_rows = pairs.Size() * repeats;
+
+    f64 sum = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < rows.Size(); ++index)
+        {
+            sum += (f64)rows.At(index)[x0_key];
+        }
+    }
+    PrintResult("x0, operator[] chain", NanosecondsSince(start, num_rows), sum);
+
+    JSONPath x0_path;
+    x0_path.Compile("$.pairs[*].x0");
+    for (const JSONObject *target : {&doc, &table_doc})
+    {
+        sum = 0;
+        start = Clock::now();
+        for (u64 repeat = 0; repeat < repeats; ++repeat)
+        {
+            x0_path.Run(*target, [&sum](const PathValue& x0) { sum += x0.AsDouble(); });
+        }
+        PrintResult(target == &doc ? "$.pairs[*].x0" : "$.pairs[*].x0, table", NanosecondsSince(start, num_rows), 
+                    sum);
+    }
+
+    sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (u64 index = 0; index < rows.Size(); ++index)
+        {
+            const JSONValue& pair = rows.At(index);
+            if ((f64)pair[x0_key] > 0)
+            {
+                sum += (f64)pair[y0_key];
+            }
+        }
+    }
+    PrintResult("x0 > 0 then y0, operator[] chain", NanosecondsSince(start, num_rows), sum);
+
+    JSONPath filter_path;
+    filter_path.Compile("$.pairs[?(@.x0 > 0)].y0");
+    for (const JSONObject *target : {&doc, &table_doc})
+    {
+        sum = 0;
+        start = Clock::now();
+        for (u64 repeat = 0; repeat < repeats; ++repeat)
+        {
+            filter_path.Run(*target, [&sum](const PathValue& y0) { sum += y0.AsDouble(); });
+        }
+        PrintResult(target == &doc ? "$.pairs[?(@.x0 > 0)].y0" : "$.pairs[?(@.x0 > 0)].y0, table", 
+                    NanosecondsSince(start, num_rows), sum);
+    }
+}
+
+/**
+ * the naive loop is what aggregating looks like without the kernels, an iterator walk
+ * with a type check per element. iterating converts a packed array to GENERIC, so it
+ * runs over the GENERIC copy
+ */
+static Summary NaiveSummarize(const JSONArray& arr)
+{
+    Summary summary = {0, 0, std::numeric_limits<f64>::infinity(), -std::numeric_limits<f64>::infinity()};
+    for (const JSONValue& value : arr)
+    {
+        f64 num = 0;
+        if (value.type == JSONObject::ValueType::INT)
+        {
+            num = value.int_val;
+        }
+        else if (value.type == JSONObject::ValueType::DOUBLE)
+        {
+            num = value.double_val;
+        }
+        else
+        {
+            continue;
+        }
+
+        ++summary.count;
+        summary.sum += num;
+        summary.min = std::min(summary.min, num);
+        summary.max = std::max(summary.max, num);
+    }
+
+    return summary;
+}
+
+void BenchAggregate(const JSONArray& pairs, u64 num_values, u64 repeats)
+{
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<f64> dist(-180.0, 180.0);
+    JSONArray doubles(JSONArray::Storage::DOUBLES);
+    JSONArray ints(JSONArray::Storage::INTS);
+    for (u64 index = 0; index < num_values; ++index)
+    {
+        f64 num = dist(rng);
+        doubles.PushBack(num);
+        ints.PushBack((s32)(num * 1000));
+    }
+
+    // NOTE(19.10.26): the non const At converts the copies to GENERIC
+    JSONArray generic_doubles = doubles;
+    generic_doubles.At(0);
+    JSONArray generic_ints = ints;
+    generic_ints.At(0);
+
+    struct Input
+    {
+        const char *name;
+        const JSONArray *packed;
+        const JSONArray *generic;
+    };
+    Input inputs[] = {{"doubles", &doubles, &generic_doubles}, {"ints", &ints, &generic_ints}};
+    for (const Input& input : inputs)
+    {
+        f64 sum = 0;
+        Clock::time_point start = Clock::now();
+        for (u64 repeat = 0; repeat < repeats; ++repeat)
+        {
+            sum += NaiveSummarize(*input.generic).sum;
+        }
+        std::cout << input.name << ", ";
+        PrintResult("iterator loop", NanosecondsSince(start, num_values * repeats), sum);
+
+        for (AggregateKernel kernel : {AggregateKernel::SCALAR, AggregateKernel::AVX2})
+        {
+            sum = 0;
+            start = Clock::now();
+            for (u64 repeat = 0; repeat < repeats; ++repeat)
+            {
+                sum += Summarize(*input.packed, kernel).sum;
+            }
+            std::cout << input.name << ", ";
+            PrintResult(kernel == AggregateKernel::SCALAR ? "Summarize scalar" : "Summarize AVX2", 
+                        NanosecondsSince(start, num_values * repeats), sum);
+        }
+    }
+
+    u64 bins[64] = {};
+    Clock::time_point start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (const JSONValue& value : generic_doubles)
+        {
+            if (value.type == JSONObject::ValueType::DOUBLE && value.double_val >= -90.0 && value.double_val < 90.0)
+            {
+                ++bins[std::min((u64)((value.double_val + 90.0) * (64 / 180.0)), (u64)63)];
+            }
+        }
+    }
+    PrintResult("histogram, iterator loop", NanosecondsSince(start, num_values * repeats), (f64)bins[0]);
+
+    for (AggregateKernel kernel : {AggregateKernel::SCALAR, AggregateKernel::AVX2})
+    {
+        std::fill(bins, bins + 64, 0);
+        start = Clock::now();
+        for (u64 repeat = 0; repeat < repeats; ++repeat)
+        {
+            Histogram(doubles, -90.0, 90.0, Span<u64>(bins, 64), kernel);
+        }
+        PrintResult(kernel == AggregateKernel::SCALAR ? "histogram, scalar" : "histogram, AVX2", 
+                    NanosecondsSince(start, num_values * repeats), (f64)bins[0]);
+    }
+
+    JSONArray table = pairs;
+    table.ToTable();
+    u64 num_rows = pairs.Size() * repeats;
+    f64 sum = 0;
+    start = Clock::now();
+    for (u64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (const JSONValue& value : pairs)
+        {
+            const JSONObject& pair = value;
+            const JSONValue& x0 = pair.Get<x0_key>();
+            if (x0.type == JSONObject::ValueType::DOUBLE)
+            {
+                sum += x0.double_val;
+            }
+        }
+    }
+    PrintResult("x0 field, iterator loop", NanosecondsSince(start, num_rows), sum);
+
+    const JSONArray *layouts[] = {&pairs, &table};
+    for (const JSONArray *arr : layouts)
+    {
+        for (AggregateKernel kernel : {AggregateKernel::SCALAR, AggregateKernel::AVX2})
+        {
+            sum = 0;
+            start = Clock::now();
+            for (u64 repeat = 0; repeat < repeats; ++repeat)
+            {
+                sum += Summarize(*arr, x0_key, kernel).sum;
+            }
+            std::cout << (arr == &table ? "x0 field, table, " : "x0 field, rows, ");
+            PrintResult(kernel == AggregateKernel::SCALAR ? "scalar" : "AVX2", NanosecondsSince(start, num_rows), sum);
+        }
+    }
+}
+
+void BenchArrayIndex(u64 num_rows, u64 num_lookups)
+{
+    static constexpr Key id_key = "id"_key;
+    JSONArray rows;
+    rows.Reserve(num_rows);
+    for (u64 index = 0; index < num_rows; ++index)
+    {
+        JSONObject row;
+        row.Put("id", (s32)index);
+        row.Put("name", "user" + std::to_string(index));
+        rows.PushBack(JSONValue(std::move(row)));
+    }
+
+    std::mt19937_64 rng(2024);
+    std::vector<s32> ids(num_lookups);
+    for (s32& id : ids)
+    {
+        id = (s32)(rng() % num_rows);
+    }
+
+    // NOTE(19.10.26): a scan is O(n), it only gets a sample of the lookups
+    u64 num_scans = std::min(num_lookups, (u64)200);
+    f64 checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (u64 lookup = 0; lookup < num_scans; ++lookup)
+    {
+        s64 position = 0;
+        for (const JSONValue& value : rows)
+        {
+            const JSONObject& row = value;
+            if ((s32)row.Get<id_key>() == ids[lookup])
+            {
+                break;
+            }
+            ++position;
+        }
+        checksum += position;
+    }
+    PrintResult("iterator scan", NanosecondsSince(start, num_scans), checksum);
+
+    checksum = 0;
+    start = Clock::now();
+    for (u64 lookup = 0; lookup < num_scans; ++lookup)
+    {
+        checksum += rows.Find(id_key, JSONValue(ids[lookup]));
+    }
+    PrintResult("Find, no index", NanosecondsSince(start, num_scans), checksum);
+
+    JSONArray::IndexStats stats = rows.BuildIndex("id");
+    std::cout << "BuildIndex: " << stats.build_seconds * 1e3 << " ms, " << stats.entries << " entries, " 
+              << stats.bytes / 1024 << " KiB (" << (f64)stats.bytes / stats.entries << " bytes per entry)\n";
+
+    checksum = 0;
+    start = Clock::now();
+    for (u64 lookup = 0; lookup < num_lookups; ++lookup)
+    {
+        checksum += rows.Find(id_key, JSONValue(ids[lookup]));
+    }
+    PrintResult("Find, index", NanosecondsSince(start, num_lookups), checksum);
+
+    JSONArray table = rows;
+    table.ToTable();
+    checksum = 0;
+    start = Clock::now();
+    for (u64 lookup = 0; lookup < num_lookups; ++lookup)
+    {
+        checksum += table.Find(id_key, JSONValue(ids[lookup]));
+    }
+    PrintResult("Find, index, table", NanosecondsSince(start, num_lookups), checksum);
+
+    // NOTE(19.10.26): what keeping the index costs the writes
+    JSONArray plain = rows;
+    plain.DropIndex("id");
+    for (JSONArray *arr : {&plain, &rows})
+    {
+        start = Clock::now();
+        for (u64 index = 0; index < num_lookups; ++index)
+        {
+            JSONObject row;
+            row.Put("id", (s32)(num_rows + index));
+            arr->PushBack(JSONValue(std::move(row)));
+        }
+        PrintResult(arr == &rows ? "PushBack, index" : "PushBack, no index", NanosecondsSince(start, num_lookups), 
+                    (f64)arr->Size());
+    }
+
+    u64 num_erases = std::min(num_lookups, (u64)100);
+    for (JSONArray *arr : {&plain, &rows})
+    {
+        start = Clock::now();
+        for (u64 index = 0; index < num_erases; ++index)
+        {
+            arr->Erase(index * 7);
+        }
+        PrintResult(arr == &rows ? "Erase, index" : "Erase, no index", NanosecondsSince(start, num_erases), 
+                    (f64)arr->Size());
+    }
+}
+
+static JSONArray RemovalRows(u64 num_rows)
+{
+    JSONArray rows;
+    rows.Reserve(num_rows);
+    for (u64 index = 0; index < num_rows; ++index)
+    {
+        JSONObject row;
+        row.Put("id", (s32)index);
+        rows.PushBack(JSONValue(std::move(row)));
+    }
+
+    return rows;
+}
+
+void BenchRemoveIf(u64 max_rows)
+{
+    static constexpr Key id_key = "id"_key;
+    auto is_even = [](const JSONValue& row) { return row[id_key].int_val % 2 == 0; };
+
+    // NOTE(19.10.26): every Erase moves the tail of the array, the cost per removed
+    // element grows with the array. the one pass removals should stay flat
+    for (u64 num_rows = max_rows / 100; num_rows <= max_rows / 25; num_rows *= 2)
+    {
+        JSONArray rows = RemovalRows(num_rows);
+        Clock::time_point start = Clock::now();
+        for (u64 index = 0; index < num_rows / 2; ++index)
+        {
+            rows.Erase(index);
+        }
+        std::string name = "Erase loop, " + std::to_string(num_rows) + " rows";
+        PrintResult(name.c_str(), NanosecondsSince(start, num_rows / 2), (f64)rows.Size());
+    }
+
+    for (u64 num_rows = max_rows / 4; num_rows <= max_rows; num_rows *= 2)
+    {
+        JSONArray rows = RemovalRows(num_rows);
+        Clock::time_point start = Clock::now();
+        rows.RemoveIf(is_even);
+        std::string name = "RemoveIf, " + std::to_string(num_rows) + " rows";
+        PrintResult(name.c_str(), NanosecondsSince(start, num_rows / 2), (f64)rows.Size());
+
+        rows = RemovalRows(num_rows);
+        std::vector<u64> evens;
+        for (u64 index = 0; index < num_rows; index += 2)
+        {
+            evens.push_back(index);
+        }
+        start = Clock::now();
+        rows.EraseIndices(Span<const u64>(evens.data(), evens.size()));
+        name = "EraseIndices, " + std::to_string(num_rows) + " rows";
+        PrintResult(name.c_str(), NanosecondsSince(start, evens.size()), (f64)rows.Size());
+
+        JSONArray doubles;
+        for (u64 index = 0; index < num_rows; ++index)
+        {
+            doubles.PushBack((f64)index);
+        }
+        start = Clock::now();
+        doubles.RemoveIf([](const JSONValue& num) { return (s64)num.double_val % 2 == 0; });
+        name = "RemoveIf, packed, " + std::to_string(num_rows) + " doubles";
+        PrintResult(name.c_str(), NanosecondsSince(start, num_rows - doubles.Size()), (f64)doubles.Size());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    u64 num_pairs = 100000;
+    if (argc > 1)
+    {
+        num_pairs = std::stoull(argv[1]);
+    }
+
+    JSONArray pairs = CreatePairs(num_pairs);
+
+    u64 repeats = num_pairs < 1000000 ? 1000000 / num_pairs : 1;
+
+    std::cout << "--- key lookup, " << num_pairs << " haversine pairs ---\n";
+    BenchKeyLookup(pairs, repeats);
+
+    std::cout << "--- serialize, " << num_pairs << " haversine pairs ---\n";
+    BenchSerialize(pairs, num_pairs < 100000 ? 100000 / num_pairs : 1);
+
+    std::cout << "--- generate to /dev/null, ns per pair, " << num_pairs << " haversine pairs ---\n";
+    BenchGeneratePairs(num_pairs);
+
+    std::cout << "--- number formatting, 1000000 values ---\n";
+    BenchNumberFormat(1000000);
+
+    std::cout << "--- compare, ns per compare, " << num_pairs << " haversine pairs ---\n";
+    BenchCompare(num_pairs, 100);
+
+    std::cout << "--- diff and patch, ns per op, " << num_pairs << " haversine pairs ---\n";
+    BenchDiff(num_pairs, 100);
+
+    std::cout << "--- remove churn, 10000 live keys ---\n";
+    BenchRemoveChurn(10000, 4, 250000);
+
+    std::cout << "--- member walk, ns per member, 100000 members ---\n";
+    BenchMemberWalk(100000, 20);
+
+    std::cout << "--- drop a document, ns per drop, " << num_pairs << " haversine pairs ---\n";
+    BenchDeferredDrop(num_pairs, 10);
+
+    std::cout << "--- concurrent reads of a frozen document, " << num_pairs << " haversine pairs ---\n";
+    BenchFrozenReads(pairs, repeats, 32);
+
+    std::cout << "--- scan x0 y0 x1 y1, ns per value, " << num_pairs << " haversine pairs ---\n";
+    BenchTableScan(pairs, repeats);
+
+    std::cout << "--- extract x0 y0 x1 y1, ns per value, " << num_pairs << " haversine pairs ---\n";
+    BenchExtractColumn(pairs, repeats);
+
+    std::cout << "--- JSONPath, ns per pair, " << num_pairs << " haversine pairs ---\n";
+    BenchJSONPath(pairs, repeats);
+
+    std::cout << "--- aggregate, ns per value, 1000000 values and " << num_pairs << " haversine pairs ---\n";
+    std::cout << "AVX2 kernels: " << (HasAVX2Kernels() ? "yes" : "no") << "\n";
+    BenchAggregate(pairs, 1000000, 20);
+
+    std::cout << "--- lookup by id, ns per op, " << num_pairs << " rows ---\n";
+    BenchArrayIndex(num_pairs, 1000000);
+
+    std::cout << "--- removing half of the rows, ns per removed element ---\n";
+    BenchRemoveIf(1000000);
+
+    std::cout << "--- shared state store, 10000 keys, 200000 ops per thread ---\n";
+    BenchContention(10000, 200000, 32);
+
+    return 0;
+}
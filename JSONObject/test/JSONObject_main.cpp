@@ -4,11 +4,54 @@
 /* Author:   Oron                            */ 
 /* ------------------------------------------*/
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <thread>
+#include <unistd.h>
+
+#include "Aggregate.h"
+#include "CBOR.h"
+#include "ConcurrentObject.h"
 #include "JSONObject.h"
+#include "JSONPatch.h"
+#include "JSONPath.h"
+#include "JSONSerializer.h"
+#include "JSONWriter.h"
+#include "Snapshot.h"
+#include "NumberFormat.h"
+#include "Reclaimer.h"
 #include "generic_test.h"
 
 using namespace JSORON;
 
+// NOTE(19.10.26): atomic, the reclaimer thread allocates too
+static std::atomic<u64> num_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    ++num_allocations;
+    void *mem = std::malloc(size);
+    if (!mem)
+    {
+        throw std::bad_alloc();
+    }
+    return mem;
+}
+
+void operator delete(void *mem) noexcept
+{
+    std::free(mem);
+}
+
+void operator delete(void *mem, std::size_t) noexcept
+{
+    operator delete(mem);
+}
+
 JSONObject CreateJson()
 {
     typedef JSONObject::JSONArray JSONArray;
@@ -141,6 +184,1494 @@ void TestPutJSONObject(Tester& tester)
     tester.AssertEqual(hello_str, std::string("good bey"), "TestPutJSONObject", __LINE__);
 }
 
+void TestJSONArrayDeepCopy(Tester& tester)
+{
+    typedef JSONObject::JSONArray JSONArray;
+
+    JSONObject json = CreateJson();
+
+    JSONArray copy = json["ArrayOfJsons"];
+    copy.At(0)["num"] = 42;
+
+    tester.AssertEqual((int)copy.At(0)["num"], 42, "TestJSONArrayDeepCopy", __LINE__);
+    tester.AssertEqual((int)json["ArrayOfJsons"].json_arr.At(0)["num"], 0, "TestJSONArrayDeepCopy", __LINE__);
+
+    JSONArray moved(std::move(copy));
+    tester.AssertEqual(moved.Size(), (u64)5, "TestJSONArrayDeepCopy", __LINE__);
+    tester.AssertEqual(copy.Size(), (u64)0, "TestJSONArrayDeepCopy", __LINE__);
+}
+
+void TestJSONArrayErase(Tester& tester)
+{
+    typedef JSONObject::JSONArray JSONArray;
+
+    JSONObject json = CreateJson();
+    JSONArray& json_arr = json["ArrayOfJsons"];
+
+    JSONValue erased = json_arr.Erase(4);
+    tester.AssertEqual((int)erased["num"], 4, "TestJSONArrayErase", __LINE__);
+    
+    erased = json_arr.Erase(0);
+    tester.AssertEqual((int)erased["num"], 0, "TestJSONArrayErase", __LINE__);
+    tester.AssertEqual(json_arr.Size(), (u64)3, "TestJSONArrayErase", __LINE__);
+    tester.AssertEqual((int)json_arr.At(0)["num"], 1, "TestJSONArrayErase", __LINE__);
+}
+
+void TestPackedArrays(Tester& tester)
+{
+    typedef JSONObject::JSONArray JSONArray;
+
+    JSONObject json = CreateJson();
+    JSONArray& int_arr = json["nestedJson"]["nestedIntArr"];
+    
+    tester.AssertEqual(int_arr.GetStorage() == JSONArray::Storage::INTS, true, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(int_arr.Ints().Size(), (u64)3, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(int_arr.Ints()[2], 3, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(int_arr.Doubles().Size(), (u64)0, "TestPackedArrays", __LINE__);
+
+    JSONArray& double_arr = json.AddArr<f64>("doubleArr");
+    double_arr.PushBack(1.5);
+    double_arr.PushBack(2.5);
+    f64 sum = 0;
+    for (f64 value : double_arr.Doubles())
+    {
+        sum += value;
+    }
+    tester.AssertEqual(sum, 4.0, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(json["doubleArr"].json_arr == double_arr, true, "TestPackedArrays", __LINE__);
+
+    double_arr.PushBack("not a double");
+    tester.AssertEqual(double_arr.GetStorage() == JSONArray::Storage::GENERIC, true, "TestPackedArrays", __LINE__);
+    tester.AssertEqual((f64)double_arr.At(1), 2.5, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(std::string(double_arr.At(2)), std::string("not a double"), "TestPackedArrays", __LINE__);
+
+    JSONValue erased = int_arr.Erase(1);
+    tester.AssertEqual(erased.int_val, 2, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(int_arr.GetStorage() == JSONArray::Storage::INTS, true, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(int_arr.Ints()[1], 3, "TestPackedArrays", __LINE__);
+
+    // NOTE(19.10.26): const reads leave a shared packed body packed, the spans of the 
+    // other copies stay valid and readers on other threads don't race
+    const JSONArray shared = int_arr;
+    const JSONArray& read_arr = int_arr;
+    Span<const s32> ints = read_arr.Ints();
+    std::atomic<s32> element_sum(0);
+    std::vector<std::thread> readers;
+    for (u64 reader = 0; reader < 4; ++reader)
+    {
+        readers.emplace_back([&shared, &element_sum]()
+        {
+            for (const JSONValue& value : shared)
+            {
+                element_sum += value.int_val;
+            }
+            element_sum += shared.At(0).int_val;
+        });
+    }
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    tester.AssertEqual(element_sum.load(), 4 * (1 + 3 + 1), "TestPackedArrays", __LINE__);
+    tester.AssertEqual(shared.GetStorage() == JSONArray::Storage::INTS, true, "TestPackedArrays", __LINE__);
+    tester.AssertEqual(ints[1], 3, "TestPackedArrays", __LINE__);
+}
+
+JSONObject CreateAndMoveJson()
+{
+    JSONObject json = CreateJson();
+    JSONObject moved(std::move(json));
+    
+    JSONObject assigned;
+    assigned = std::move(moved);
+    return assigned;
+}
+
+void TestMoveDoesNotAllocate(Tester& tester)
+{
+    u64 before = num_allocations;
+    JSONObject json = CreateJson();
+    u64 create_allocations = num_allocations - before;
+
+    before = num_allocations;
+    JSONObject moved_json = CreateAndMoveJson();
+    u64 create_and_move_allocations = num_allocations - before;
+
+    tester.AssertEqual(create_and_move_allocations, create_allocations, "TestMoveDoesNotAllocate", __LINE__);
+
+    before = num_allocations;
+    json["intKey"] = 7;
+    json["doubleKey"] = 7.5;
+    JSONValue nested(std::move(json["nestedJson"]));
+    tester.AssertEqual(num_allocations - before, (u64)0, "TestMoveDoesNotAllocate", __LINE__);
+
+    moved_json.Put(std::string("movedNested"), std::move(nested));
+    
+    tester.AssertEqual((int)moved_json["movedNested"]["nestedInt"], 42, "TestMoveDoesNotAllocate", __LINE__);
+    tester.AssertEqual(json["nestedJson"].type == JSONObject::ValueType::NULL_TYPE, true, "TestMoveDoesNotAllocate", __LINE__);
+}
+
+void TestEmplace(Tester& tester)
+{
+    JSONObject json;
+
+    JSONValue& value = json.Emplace("key", 1);
+    tester.AssertEqual((int)value, 1, "TestEmplace", __LINE__);
+
+    JSONValue& existing = json.Emplace("key", 2);
+    tester.AssertEqual(&existing == &value, true, "TestEmplace", __LINE__);
+    tester.AssertEqual((int)json["key"], 1, "TestEmplace", __LINE__);
+
+    JSONObject& nested = json.AddObj("nested");
+    nested.Put("nestedKey", "nested");
+    tester.AssertEqual(std::string(json["nested"]["nestedKey"]), std::string("nested"), "TestEmplace", __LINE__);
+}
+
+void TestSnapshotSharing(Tester& tester)
+{
+    typedef JSONObject::JSONArray JSONArray;
+
+    JSONObject json = CreateJson();
+
+    u64 before = num_allocations;
+    JSONObject snapshot = json;
+    tester.AssertEqual(num_allocations - before, (u64)0, "TestSnapshotSharing", __LINE__);
+
+    const JSONObject& const_json = json;
+    const JSONObject& const_snapshot = snapshot;
+    tester.AssertEqual(&const_json["intKey"] == &const_snapshot["intKey"], true, "TestSnapshotSharing", __LINE__);
+
+    snapshot["nestedJson"]["nestedInt"] = 7;
+    tester.AssertEqual((int)const_json["nestedJson"]["nestedInt"], 42, "TestSnapshotSharing", __LINE__);
+    tester.AssertEqual((int)const_snapshot["nestedJson"]["nestedInt"], 7, "TestSnapshotSharing", __LINE__);
+
+    // NOTE(19.10.26): only the path to nestedInt was copied, its siblings are still shared
+    const JSONArray& json_arr = const_json["ArrayOfJsons"];
+    const JSONArray& snapshot_arr = const_snapshot["ArrayOfJsons"];
+    tester.AssertEqual(&json_arr.At(0) == &snapshot_arr.At(0), true, "TestSnapshotSharing", __LINE__);
+
+    const JSONArray& json_int_arr = const_json["nestedJson"]["nestedIntArr"];
+    const JSONArray& snapshot_int_arr = const_snapshot["nestedJson"]["nestedIntArr"];
+    tester.AssertEqual(json_int_arr.Ints().Data() == snapshot_int_arr.Ints().Data(), true, "TestSnapshotSharing", __LINE__);
+}
+
+void TestKeyLookup(Tester& tester)
+{
+    JSONObject json;
+    for (s32 index = 0; index < 100; ++index)
+    {
+        json.Put("key" + std::to_string(index), index);
+    }
+
+    u64 before = num_allocations;
+    Key key_42("key42", 5);
+    s32 sum = (s32)json[key_42] + (s32)json["key7"] + (s32)json[std::string_view("key99")];
+    tester.AssertEqual(num_allocations - before, (u64)0, "TestKeyLookup", __LINE__);
+    tester.AssertEqual(sum, 42 + 7 + 99, "TestKeyLookup", __LINE__);
+    tester.AssertEqual(json["key100"].type == JSONObject::ValueType::BAD_TYPE, true, "TestKeyLookup", __LINE__);
+
+    const JSONObject nested = CreateJson();
+    Key nested_key("nestedJson", 10);
+    Key nested_int_key("nestedInt", 9);
+    for (u64 index = 0; index < 3; ++index)
+    {
+        tester.AssertEqual((s32)nested[nested_key][nested_int_key], 42, "TestKeyLookup", __LINE__);
+    }
+}
+
+static constexpr Key int_key = "intKey"_key;
+static constexpr Key missing_key = "missingKey"_key;
+static constexpr Key key_99 = "key99"_key;
+
+void TestStaticKey(Tester& tester)
+{
+    static_assert(int_key.Hash() == HashKey("intKey", 6), "key hash must be computed at compile time");
+
+    JSONObject json = CreateJson();
+    const JSONObject& const_json = json;
+
+    tester.AssertEqual((s32)const_json.Get<int_key>(), 13, "TestStaticKey", __LINE__);
+    tester.AssertEqual(const_json.Get<missing_key>().type == JSONObject::ValueType::BAD_TYPE, true, "TestStaticKey", __LINE__);
+
+    json.Get<int_key>() = 14;
+    tester.AssertEqual((s32)json["intKey"], 14, "TestStaticKey", __LINE__);
+
+    JSONObject big_json;
+    for (s32 index = 0; index < 100; ++index)
+    {
+        big_json.Put("key" + std::to_string(index), index);
+    }
+    tester.AssertEqual((s32)big_json.Get<key_99>(), 99, "TestStaticKey", __LINE__);
+}
+
+void TestSerializer(Tester& tester)
+{
+    JSONObject json;
+    json.Put("int", -42);
+    json.Put("double", 2.5);
+    json.Put("str", std::string("a\"b\\c\nd\x01"));
+    json.Put("ints", JSONArray());
+    json.AddArr<s32>("packed").PushBack(7);
+    json.AddObj("empty");
+    JSONObject::JSONValue null_value;
+    json.Put("null", null_value);
+
+    JSONSerializer compact;
+    compact.Write(json);
+    tester.AssertEqual(compact.Str(), 
+                       std::string("{\"int\":-42,\"double\":2.5,\"str\":\"a\\\"b\\\\c\\nd\\u0001\",") + 
+                       "\"ints\":[],\"packed\":[7],\"empty\":{},\"null\":null}", 
+                       "TestSerializer", __LINE__);
+
+    JSONObject nested;
+    nested.AddObj("obj").Put("a", 1);
+    nested.AddArr<f64>("arr").PushBack(1.0);
+
+    JSONSerializer pretty(JSONSerializer::Style::PRETTY);
+    pretty.Write(nested);
+    tester.AssertEqual(pretty.Str(), std::string("{\n\t\"obj\": {\n\t\t\"a\": 1\n\t},\n\t\"arr\": [\n\t\t1.0\n\t]\n}"), 
+                       "TestSerializer", __LINE__);
+
+    FILE *file = std::tmpfile();
+    {
+        JSONSerializer to_fd(fileno(file), JSONSerializer::Style::COMPACT, 16);
+        to_fd.Write(json);
+        tester.AssertEqual(to_fd.Flush(), true, "TestSerializer", __LINE__);
+    }
+
+    std::string from_fd(compact.View().size(), '\0');
+    std::rewind(file);
+    u64 num_read = std::fread(&from_fd[0], 1, from_fd.size(), file);
+    std::fclose(file);
+    tester.AssertEqual(num_read, compact.View().size(), "TestSerializer", __LINE__);
+    tester.AssertEqual(from_fd, compact.Str(), "TestSerializer", __LINE__);
+}
+
+std::string IntToText(s64 num)
+{
+    char text[max_int_chars];
+    return std::string(text, FormatInt(text, num));
+}
+
+std::string DoubleToText(f64 num)
+{
+    char text[max_double_chars];
+    return std::string(text, FormatDouble(text, num));
+}
+
+void TestNumberFormat(Tester& tester)
+{
+    tester.AssertEqual(IntToText(0), std::string("0"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(9), std::string("9"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(10), std::string("10"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(-100), std::string("-100"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(1234567), std::string("1234567"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(std::numeric_limits<s64>::max()), std::string("9223372036854775807"), 
+                       "TestNumberFormat", __LINE__);
+    tester.AssertEqual(IntToText(std::numeric_limits<s64>::min()), std::string("-9223372036854775808"), 
+                       "TestNumberFormat", __LINE__);
+
+    char text[max_int_chars];
+    tester.AssertEqual(std::string(text, FormatUInt(text, std::numeric_limits<u64>::max())), 
+                       std::string("18446744073709551615"), "TestNumberFormat", __LINE__);
+
+    tester.AssertEqual(DoubleToText(0.1), std::string("0.1"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(DoubleToText(-24.136337), std::string("-24.136337"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(DoubleToText(3.0), std::string("3.0"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(DoubleToText(-0.0), std::string("-0.0"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(DoubleToText(1e300), std::string("1e+300"), "TestNumberFormat", __LINE__);
+    tester.AssertEqual(DoubleToText(std::numeric_limits<f64>::quiet_NaN()), std::string("null"), 
+                       "TestNumberFormat", __LINE__);
+}
+
+void WritePairs(JSONWriter& writer)
+{
+    writer.BeginObject();
+    writer.Key("name");
+    writer.String("pairs");
+    writer.Key("pairs");
+    writer.BeginArray();
+    for (s32 index = 0; index < 3; ++index)
+    {
+        writer.BeginObject();
+        writer.Key("x0");
+        writer.Double(index + 0.5);
+        writer.Key("id");
+        writer.Int(index);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("empty");
+    writer.BeginArray();
+    writer.EndArray();
+    writer.Key("nested");
+    writer.Value(CreateJson());
+    writer.EndObject();
+}
+
+JSONObject CreatePairsJson()
+{
+    JSONObject json;
+    json.Put("name", "pairs");
+    JSONArray pairs;
+    for (s32 index = 0; index < 3; ++index)
+    {
+        JSONObject pair;
+        pair.Put("x0", index + 0.5);
+        pair.Put("id", index);
+        pairs.PushBack(JSONObject::JSONValue(std::move(pair)));
+    }
+    json.Put("pairs", pairs);
+    json.Put("empty", JSONArray());
+    json.Put("nested", CreateJson());
+
+    return json;
+}
+
+void TestJSONWriter(Tester& tester)
+{
+    JSONObject expected = CreatePairsJson();
+
+    for (JSONWriter::Style style : {JSONWriter::Style::COMPACT, JSONWriter::Style::PRETTY})
+    {
+        JSONWriter writer(style);
+        WritePairs(writer);
+        tester.AssertEqual(writer.Done(), true, "TestJSONWriter", __LINE__);
+
+        JSONSerializer serializer(style);
+        serializer.Write(expected);
+        tester.AssertEqual(writer.Str(), serializer.Str(), "TestJSONWriter", __LINE__);
+    }
+
+    FILE *file = std::tmpfile();
+    {
+        JSONWriter writer(fileno(file), JSONWriter::Style::COMPACT, 64);
+        WritePairs(writer);
+        tester.AssertEqual(writer.Flush(), true, "TestJSONWriter", __LINE__);
+    }
+
+    JSONSerializer serializer;
+    serializer.Write(expected);
+    std::string from_fd(serializer.View().size(), '\0');
+    std::rewind(file);
+    u64 num_read = std::fread(&from_fd[0], 1, from_fd.size(), file);
+    std::fclose(file);
+    tester.AssertEqual(num_read, serializer.View().size(), "TestJSONWriter", __LINE__);
+    tester.AssertEqual(from_fd, serializer.Str(), "TestJSONWriter", __LINE__);
+
+    JSONWriter value_for_key;
+    value_for_key.BeginObject();
+    tester.AssertEqual(value_for_key.Int(1), false, "TestJSONWriter", __LINE__);
+    tester.AssertEqual(value_for_key.Good(), false, "TestJSONWriter", __LINE__);
+
+    JSONWriter key_in_array;
+    key_in_array.BeginArray();
+    tester.AssertEqual(key_in_array.Key("key"), false, "TestJSONWriter", __LINE__);
+
+    JSONWriter mismatched_end;
+    mismatched_end.BeginArray();
+    tester.AssertEqual(mismatched_end.EndObject(), false, "TestJSONWriter", __LINE__);
+
+    JSONWriter dangling_key;
+    dangling_key.BeginObject();
+    dangling_key.Key("key");
+    tester.AssertEqual(dangling_key.EndObject(), false, "TestJSONWriter", __LINE__);
+
+    JSONWriter two_roots;
+    two_roots.Int(1);
+    tester.AssertEqual(two_roots.Done(), true, "TestJSONWriter", __LINE__);
+    tester.AssertEqual(two_roots.Int(2), false, "TestJSONWriter", __LINE__);
+    tester.AssertEqual(two_roots.Str(), std::string("1"), "TestJSONWriter", __LINE__);
+
+    JSONWriter too_deep;
+    b8 all_opened = 1;
+    for (u32 level = 0; level < JSONWriter::max_depth; ++level)
+    {
+        all_opened = all_opened && too_deep.BeginArray();
+    }
+    tester.AssertEqual(all_opened, true, "TestJSONWriter", __LINE__);
+    tester.AssertEqual(too_deep.BeginArray(), false, "TestJSONWriter", __LINE__);
+}
+
+void TestCBOR(Tester& tester)
+{
+    JSONObject small;
+    small.Put("a", 1);
+    small.Put("b", -500);
+    small.Put("c", 1.5);
+    small.Put("d", 0.1);
+
+    CBOREncoder encoder;
+    encoder.Encode(small);
+    std::vector<u8> expected_bytes = {0xa4,
+                                      0x61, 'a', 0x01,
+                                      0x61, 'b', 0x39, 0x01, 0xf3,
+                                      0x61, 'c', 0xfa, 0x3f, 0xc0, 0x00, 0x00,
+                                      0x61, 'd', 0xfb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a};
+    tester.AssertEqual(encoder.Bytes() == expected_bytes, true, "TestCBOR", __LINE__);
+
+    JSONObject json = CreatePairsJson();
+    encoder.Clear();
+    encoder.Encode(json);
+
+    CBORDecoder decoder;
+    JSONObject decoded = decoder.Decode(encoder.Bytes());
+    tester.AssertEqual(decoder.Good(), true, "TestCBOR", __LINE__);
+    tester.AssertEqual(decoded == json, true, "TestCBOR", __LINE__);
+    tester.AssertEqual(decoded["nested"]["nestedJson"]["nestedIntArr"].json_arr.GetStorage() == JSONArray::Storage::INTS, 
+                       true, "TestCBOR", __LINE__);
+
+    // {_ "arr": [_ true, tag 1 (half 1.5), null], "big": 2^32} with indefinite lengths
+    std::vector<u8> foreign = {0xbf,
+                               0x63, 'a', 'r', 'r', 0x9f, 0xf5, 0xc1, 0xf9, 0x3e, 0x00, 0xf6, 0xff,
+                               0x63, 'b', 'i', 'g', 0x1b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+                               0xff};
+    JSONObject from_foreign = decoder.Decode(foreign);
+    tester.AssertEqual(decoder.Good(), true, "TestCBOR", __LINE__);
+    tester.AssertEqual((s32)from_foreign["arr"][(u64)0], 1, "TestCBOR", __LINE__);
+    tester.AssertEqual((f64)from_foreign["arr"][(u64)1], 1.5, "TestCBOR", __LINE__);
+    tester.AssertEqual(from_foreign["arr"][(u64)2].type == JSONObject::ValueType::NULL_TYPE, true, "TestCBOR", __LINE__);
+    tester.AssertEqual((f64)from_foreign["big"], 4294967296.0, "TestCBOR", __LINE__);
+
+    std::vector<u8> truncated(encoder.Bytes().begin(), encoder.Bytes().end() - 1);
+    decoder.Decode(truncated);
+    tester.AssertEqual(decoder.Good(), false, "TestCBOR", __LINE__);
+
+    std::vector<u8> byte_string = {0xa1, 0x61, 'a', 0x41, 0x00};
+    decoder.Decode(byte_string);
+    tester.AssertEqual(decoder.Good(), false, "TestCBOR", __LINE__);
+
+    std::vector<u8> too_deep = {0xa1, 0x61, 'a'};
+    too_deep.insert(too_deep.end(), 100000, 0x81);
+    too_deep.push_back(0x01);
+    decoder.Decode(too_deep);
+    tester.AssertEqual(decoder.Good(), false, "TestCBOR", __LINE__);
+}
+
+void TestSnapshot(Tester& tester)
+{
+    JSONObject json = CreatePairsJson();
+    for (s32 index = 0; index < 20; ++index)
+    {
+        json.Put("key" + std::to_string(index), index);
+    }
+
+    SnapshotWriter writer;
+    writer.Write(json);
+
+    Snapshot snapshot;
+    tester.AssertEqual(snapshot.Load(writer.Bytes().data(), writer.Bytes().size()), true, "TestSnapshot", __LINE__);
+
+    SnapshotValue root = snapshot.Root();
+    tester.AssertEqual(root["name"].AsStr() == "pairs", true, "TestSnapshot", __LINE__);
+    tester.AssertEqual(root["pairs"].Size(), (u64)3, "TestSnapshot", __LINE__);
+    tester.AssertEqual(root["pairs"][(u64)2]["x0"].AsDouble(), 2.5, "TestSnapshot", __LINE__);
+    tester.AssertEqual(root["key17"].AsInt(), 17, "TestSnapshot", __LINE__);
+    tester.AssertEqual(root["missing"].Type() == JSONObject::ValueType::BAD_TYPE, true, "TestSnapshot", __LINE__);
+    tester.AssertEqual(root.KeyAt(0) == "name", true, "TestSnapshot", __LINE__);
+
+    SnapshotValue int_arr = root["nested"]["nestedJson"]["nestedIntArr"];
+    tester.AssertEqual(int_arr.GetStorage() == JSONArray::Storage::INTS, true, "TestSnapshot", __LINE__);
+    tester.AssertEqual(int_arr.Ints()[2], 3, "TestSnapshot", __LINE__);
+
+    JSONObject::JSONValue materialized = root.Materialize();
+    tester.AssertEqual(*materialized.json_val == json, true, "TestSnapshot", __LINE__);
+
+    char path[] = "/tmp/jsoron_snapshot_XXXXXX";
+    s32 fd = mkstemp(path);
+    close(fd);
+    tester.AssertEqual(writer.WriteToFile(path), true, "TestSnapshot", __LINE__);
+
+    Snapshot mapped;
+    tester.AssertEqual(mapped.Open(path), true, "TestSnapshot", __LINE__);
+    tester.AssertEqual(mapped.Root()["key3"].AsInt(), 3, "TestSnapshot", __LINE__);
+    tester.AssertEqual(mapped.Root()["nested"]["strKey"].AsStr() == "str", true, "TestSnapshot", __LINE__);
+    mapped.Close();
+    unlink(path);
+
+    std::vector<u8> corrupt = writer.Bytes();
+    corrupt[0] = 'X';
+    tester.AssertEqual(snapshot.Load(corrupt.data(), corrupt.size()), false, "TestSnapshot", __LINE__);
+}
+
+void TestStructuralHash(Tester& tester)
+{
+    JSONObject json1 = CreateJson();
+    JSONObject json2 = CreateJson();
+    tester.AssertEqual(json1.Hash() == json2.Hash(), true, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(json1 == json2, true, "TestStructuralHash", __LINE__);
+
+    u64 old_hash = json1.Hash();
+    JSONObject snapshot = json1;
+    json1["nestedJson"]["nestedInt"] = 43;
+    tester.AssertEqual(json1.Hash() != old_hash, true, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(snapshot.Hash(), old_hash, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(json1 != json2, true, "TestStructuralHash", __LINE__);
+
+    json1["nestedJson"]["nestedInt"] = 42;
+    tester.AssertEqual(json1.Hash(), old_hash, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(json1 == json2, true, "TestStructuralHash", __LINE__);
+
+    JSONArray shorter;
+    shorter.PushBack(std::string("a"));
+    shorter.PushBack(1);
+    JSONArray longer = shorter;
+    longer.PushBack(2);
+    tester.AssertEqual(shorter == longer, false, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(longer == shorter, false, "TestStructuralHash", __LINE__);
+
+    JSONObject zero;
+    zero.Put("num", 0.0);
+    JSONObject negative_zero;
+    negative_zero.Put("num", -0.0);
+    tester.AssertEqual(zero.Hash() == negative_zero.Hash(), true, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(zero == negative_zero, true, "TestStructuralHash", __LINE__);
+
+    JSONObject empty;
+    JSONObject emptied;
+    emptied.AddObj("obj");
+    tester.AssertEqual(empty.Hash() == JSONObject().Hash(), true, "TestStructuralHash", __LINE__);
+    tester.AssertEqual(empty.Hash() != emptied.Hash(), true, "TestStructuralHash", __LINE__);
+}
+
+void TestRemove(Tester& tester)
+{
+    JSONObject json = CreateJson();
+    JSONObject copy = json;
+    tester.AssertEqual(json.Remove("strKey"), true, "TestRemove", __LINE__);
+    tester.AssertEqual(json.Remove("strKey"), false, "TestRemove", __LINE__);
+    tester.AssertEqual(json["strKey"].type, JSONObject::ValueType::BAD_TYPE, "TestRemove", __LINE__);
+    tester.AssertEqual((s32)json["intKey"], 13, "TestRemove", __LINE__);
+    tester.AssertEqual((std::string)copy["strKey"], std::string("str"), "TestRemove", __LINE__);
+
+    JSONObject big;
+    for (s32 index = 0; index < 20; ++index)
+    {
+        big.Put("key" + std::to_string(index), index);
+    }
+    for (s32 index = 0; index < 20; index += 2)
+    {
+        big.Remove("key" + std::to_string(index));
+    }
+
+    b8 all_found = 1;
+    for (s32 index = 0; index < 20; ++index)
+    {
+        const JSONObject& read_big = big;
+        const JSONObject::JSONValue& value = read_big["key" + std::to_string(index)];
+        all_found &= index % 2 ? value.type == JSONObject::ValueType::INT && (s32)value == index :
+                                 value.type == JSONObject::ValueType::BAD_TYPE;
+    }
+    tester.AssertEqual(all_found, true, "TestRemove", __LINE__);
+
+    // NOTE(19.10.26): a stored miss is a live member, not a tombstone
+    JSONObject lhs;
+    const JSONObject& other = big;
+    lhs.Put("a", 1);
+    lhs.Put("x", other["missing"]);
+    lhs.Put("b", 2);
+    JSONObject rhs;
+    rhs.Put("z", 0);
+    rhs.Put("a", 1);
+    rhs.Put("x", other["missing"]);
+    rhs.Put("b", 2);
+    rhs.Remove("z");
+    u64 num_members = 0;
+    for (const JSONObject::Entry<const JSONObject::JSONValue>& member : static_cast<const JSONObject&>(lhs))
+    {
+        num_members += member.key.size() > 0;
+    }
+    tester.AssertEqual(num_members, lhs.Size(), "TestRemove", __LINE__);
+    tester.AssertEqual(lhs.Size(), (u64)3, "TestRemove", __LINE__);
+    tester.AssertEqual(lhs == rhs, true, "TestRemove", __LINE__);
+    rhs.Remove("b");
+    tester.AssertEqual(lhs == rhs, false, "TestRemove", __LINE__);
+    tester.AssertEqual(rhs == lhs, false, "TestRemove", __LINE__);
+}
+
+void TestRemoveChurn(Tester& tester)
+{
+    JSONObject cache;
+    for (s32 index = 0; index < 12; ++index)
+    {
+        cache.Put("key" + std::to_string(index), index);
+    }
+    cache.Remove("key3");
+    cache.Remove("key0");
+    cache.Put("key3", 33);
+
+    JSONObject expected;
+    for (s32 index : {1, 2, 4, 5, 6, 7, 8, 9, 10, 11})
+    {
+        expected.Put("key" + std::to_string(index), index);
+    }
+    expected.Put("key3", 33);
+    tester.AssertEqual(cache == expected, true, "TestRemoveChurn", __LINE__);
+    tester.AssertEqual(cache.Hash() == expected.Hash(), true, "TestRemoveChurn", __LINE__);
+
+    JSONSerializer cache_text;
+    cache_text.Write(cache);
+    JSONSerializer expected_text;
+    expected_text.Write(expected);
+    tester.AssertEqual(cache_text.Str(), expected_text.Str(), "TestRemoveChurn", __LINE__);
+
+    // NOTE(19.10.26): a sliding window of 16 live keys over 10000 insertions
+    b8 window_ok = 1;
+    JSONObject window;
+    for (s32 index = 0; index < 10000; ++index)
+    {
+        window.Put("key" + std::to_string(index), index);
+        if (index >= 16)
+        {
+            window_ok &= window.Remove("key" + std::to_string(index - 16));
+        }
+    }
+
+    const JSONObject& read_window = window;
+    for (s32 index = 0; index < 10000; ++index)
+    {
+        const JSONObject::JSONValue& value = read_window["key" + std::to_string(index)];
+        window_ok &= index >= 10000 - 16 ? value.type == JSONObject::ValueType::INT && (s32)value == index :
+                                           value.type == JSONObject::ValueType::BAD_TYPE;
+    }
+    tester.AssertEqual(window_ok, true, "TestRemoveChurn", __LINE__);
+
+    JSONObject shared = cache;
+    shared.Remove("key1");
+    tester.AssertEqual(shared.Remove("key1"), false, "TestRemoveChurn", __LINE__);
+    tester.AssertEqual((s32)cache["key1"], 1, "TestRemoveChurn", __LINE__);
+    tester.AssertEqual(shared == cache, false, "TestRemoveChurn", __LINE__);
+}
+
+void TestMemberIteration(Tester& tester)
+{
+    JSONObject json = CreateJson();
+    json.Remove("doubleKey");
+    tester.AssertEqual(json.Size(), (u64)4, "TestMemberIteration", __LINE__);
+
+    std::string keys;
+    for (auto [key, value] : static_cast<const JSONObject&>(json))
+    {
+        keys += std::string(key) + ",";
+    }
+    tester.AssertEqual(keys, std::string("intKey,strKey,nestedJson,ArrayOfJsons,"), "TestMemberIteration", __LINE__);
+
+    JSONObject copy = json;
+    for (auto [key, value] : copy)
+    {
+        if (value.type == JSONObject::ValueType::INT)
+        {
+            value = (s32)value + 1;
+        }
+    }
+    tester.AssertEqual((s32)copy["intKey"], 14, "TestMemberIteration", __LINE__);
+    tester.AssertEqual((s32)json["intKey"], 13, "TestMemberIteration", __LINE__);
+
+    s32 int_sum = 0;
+    u64 num_strings = 0;
+    u64 num_containers = 0;
+    json.ForEachMember([&](std::string_view key, const auto& value)
+    {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, s32>)
+        {
+            int_sum += value;
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            num_strings += value.size();
+        }
+        else if constexpr (std::is_same_v<T, JSONObject> || std::is_same_v<T, JSONObject::JSONArray>)
+        {
+            ++num_containers;
+        }
+    });
+    tester.AssertEqual(int_sum, 13, "TestMemberIteration", __LINE__);
+    tester.AssertEqual(num_strings, (u64)3, "TestMemberIteration", __LINE__);
+    tester.AssertEqual(num_containers, (u64)2, "TestMemberIteration", __LINE__);
+
+    const JSONObject& read_json = json;
+    b8 is_null = read_json["missing"].Visit([](const auto& value)
+    {
+        return std::is_same_v<std::decay_t<decltype(value)>, std::nullptr_t>;
+    });
+    tester.AssertEqual(is_null, true, "TestMemberIteration", __LINE__);
+
+    JSONObject empty;
+    tester.AssertEqual(empty.begin() == empty.end(), true, "TestMemberIteration", __LINE__);
+    tester.AssertEqual(empty.Size(), (u64)0, "TestMemberIteration", __LINE__);
+}
+
+void TestReclaimer(Tester& tester)
+{
+    JSONObject kept = CreateJson();
+    {
+        Reclaimer reclaimer;
+        for (u64 index = 0; index < 10; ++index)
+        {
+            JSONObject doc = CreateJson();
+            reclaimer.Drop(std::move(doc));
+            tester.AssertEqual(doc.Size(), (u64)0, "TestReclaimer", __LINE__);
+        }
+        reclaimer.Flush();
+
+        Reclaimer::Stats stats = reclaimer.GetStats();
+        tester.AssertEqual(stats.documents_queued, (u64)10, "TestReclaimer", __LINE__);
+        tester.AssertEqual(stats.documents_reclaimed, (u64)10, "TestReclaimer", __LINE__);
+        tester.AssertEqual(stats.bytes_reclaimed > 0, true, "TestReclaimer", __LINE__);
+        tester.AssertEqual(stats.peak_pending >= 1 && stats.peak_pending <= 10, true, "TestReclaimer", __LINE__);
+
+        // NOTE(19.10.26): dropping a copy frees nothing the original still uses
+        u64 bytes_before = stats.bytes_reclaimed;
+        reclaimer.Drop(JSONObject(kept));
+        reclaimer.Flush();
+        tester.AssertEqual(reclaimer.GetStats().bytes_reclaimed, bytes_before, "TestReclaimer", __LINE__);
+
+        reclaimer.Drop(CreateJson());
+    }
+    tester.AssertEqual(kept == CreateJson(), true, "TestReclaimer", __LINE__);
+
+    Reclaimer full(0);
+    full.Drop(CreateJson());
+    Reclaimer::Stats full_stats = full.GetStats();
+    tester.AssertEqual(full_stats.documents_inline, (u64)1, "TestReclaimer", __LINE__);
+    tester.AssertEqual(full_stats.documents_queued, (u64)0, "TestReclaimer", __LINE__);
+}
+
+void TestJSONPatch(Tester& tester)
+{
+    typedef JSONObject::JSONArray JSONArray;
+
+    JSONObject from = CreateJson();
+    JSONObject to = from;
+    to["nestedJson"]["nestedInt"] = 7;
+    to.Remove("strKey");
+    to.Put("a/b~c", 1);
+    JSONArray& jsons = to["ArrayOfJsons"];
+    ((JSONObject&)jsons.At(2))["num"] = 20;
+    jsons.Erase(0);
+
+    JSONArray patch = JSONPatch::Diff(from, to);
+    tester.AssertEqual(patch.Size(), (u64)5, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::Diff(from, from).Size(), (u64)0, "TestJSONPatch", __LINE__);
+
+    JSONObject replica = CreateJson();
+    tester.AssertEqual(JSONPatch::Apply(replica, patch), true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(replica == to, true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(from == CreateJson(), true, "TestJSONPatch", __LINE__);
+
+    JSONObject packed_from;
+    JSONArray& nums = packed_from.AddArr<s32>("nums");
+    for (s32 num : {1, 2, 3, 4})
+    {
+        nums.PushBack(num);
+    }
+    JSONObject packed_to = packed_from;
+    JSONArray& new_nums = packed_to["nums"];
+    new_nums.Ints()[1] = 5;
+    new_nums.PushBack(6);
+
+    JSONArray nums_patch = JSONPatch::Diff(packed_from, packed_to);
+    tester.AssertEqual(nums_patch.Size(), (u64)2, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::Apply(packed_from, nums_patch), true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(packed_from == packed_to, true, "TestJSONPatch", __LINE__);
+    const JSONObject& read_packed = packed_from;
+    tester.AssertEqual(((const JSONArray&)read_packed["nums"]).GetStorage(), JSONArray::Storage::INTS, 
+                       "TestJSONPatch", __LINE__);
+
+    JSONObject ordered_from;
+    ordered_from.Put("a", 1);
+    ordered_from.Put("b", 2);
+    JSONObject reordered;
+    reordered.Put("b", 2);
+    reordered.Put("a", 1);
+    JSONArray reorder_patch = JSONPatch::Diff(ordered_from, reordered);
+    tester.AssertEqual(reorder_patch.Size() > 0, true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::Apply(ordered_from, reorder_patch), true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(ordered_from == reordered, true, "TestJSONPatch", __LINE__);
+
+    JSONObject gap_from;
+    gap_from.Put("a", 1);
+    gap_from.Put("c", 3);
+    JSONObject gap_to;
+    gap_to.Put("a", 1);
+    gap_to.Put("b", 2);
+    gap_to.Put("c", 3);
+    tester.AssertEqual(JSONPatch::Apply(gap_from, JSONPatch::Diff(gap_from, gap_to)), true,
+                       "TestJSONPatch", __LINE__);
+    tester.AssertEqual(gap_from == gap_to, true, "TestJSONPatch", __LINE__);
+
+    JSONObject failing = CreateJson();
+    JSONArray bad_patch;
+    JSONObject remove_op;
+    remove_op.Put("op", std::string("remove"));
+    remove_op.Put("path", std::string("/intKey"));
+    bad_patch.PushBack(JSONObject::JSONValue(std::move(remove_op)));
+    JSONObject test_op;
+    test_op.Put("op", std::string("test"));
+    test_op.Put("path", std::string("/nestedJson/nestedIntArr/1"));
+    test_op.Put("value", 3);
+    bad_patch.PushBack(JSONObject::JSONValue(std::move(test_op)));
+    tester.AssertEqual(JSONPatch::Apply(failing, bad_patch), false, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(failing == CreateJson(), true, "TestJSONPatch", __LINE__);
+
+    std::vector<std::string> tokens;
+    std::string pointer;
+    JSONPatch::AppendToken(pointer, "a/b~c");
+    JSONPatch::AppendToken(pointer, "");
+    tester.AssertEqual(pointer, std::string("/a~1b~0c/"), "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::SplitPointer(pointer, tokens), true, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(tokens.size() == 2 && tokens[0] == "a/b~c" && tokens[1].empty(), true, 
+                       "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::SplitPointer("a/b", tokens), false, "TestJSONPatch", __LINE__);
+    tester.AssertEqual(JSONPatch::SplitPointer("/a~2", tokens), false, "TestJSONPatch", __LINE__);
+}
+
+void TestFrozenDocument(Tester& tester)
+{
+    JSONObject json = CreatePairsJson();
+    for (s32 index = 0; index < 20; ++index)
+    {
+        json.Put("key" + std::to_string(index), index);
+    }
+
+    FrozenDocument frozen = FrozenDocument::Freeze(json);
+    json.Put("key3", 300);
+    json.Remove("name");
+
+    SnapshotValue root = frozen.Root();
+    tester.AssertEqual(root["key3"].AsInt(), 3, "TestFrozenDocument", __LINE__);
+    tester.AssertEqual(root["name"].AsStr() == "pairs", true, "TestFrozenDocument", __LINE__);
+    tester.AssertEqual(root["pairs"][(u64)1]["id"].AsInt(), 1, "TestFrozenDocument", __LINE__);
+
+    Snapshot snapshot;
+    tester.AssertEqual(snapshot.Load(frozen.Bytes().data(), frozen.Bytes().size()), true, 
+                       "TestFrozenDocument", __LINE__);
+
+    FrozenDocument moved(std::move(frozen));
+    tester.AssertEqual(frozen.Root().Type() == JSONObject::ValueType::BAD_TYPE, true, "TestFrozenDocument", __LINE__);
+
+    std::atomic<u64> num_mismatches(0);
+    std::vector<std::thread> readers;
+    for (u64 thread = 0; thread < 4; ++thread)
+    {
+        readers.emplace_back([&moved, &num_mismatches]()
+        {
+            for (u64 round = 0; round < 1000; ++round)
+            {
+                SnapshotValue root = moved.Root();
+                s32 sum = 0;
+                for (s32 index = 0; index < 20; ++index)
+                {
+                    sum += root["key" + std::to_string(index)].AsInt();
+                }
+
+                if (sum != 190 || root["missing"].Type() != JSONObject::ValueType::BAD_TYPE)
+                {
+                    ++num_mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    tester.AssertEqual(num_mismatches.load(), (u64)0, "TestFrozenDocument", __LINE__);
+}
+
+void TestConcurrentObject(Tester& tester)
+{
+    ConcurrentObject state(8);
+    state.Put("name", std::string("state"));
+    state.Put("name", std::string("renamed"));
+    state.Put("nested", CreateJson());
+
+    JSONValue value;
+    tester.AssertEqual(state.Get("name", value), true, "TestConcurrentObject", __LINE__);
+    tester.AssertEqual(value.str_val, std::string("renamed"), "TestConcurrentObject", __LINE__);
+    tester.AssertEqual(state.Get("missing", value), false, "TestConcurrentObject", __LINE__);
+    tester.AssertEqual(state.Remove("name"), true, "TestConcurrentObject", __LINE__);
+    tester.AssertEqual(state.Contains("name"), false, "TestConcurrentObject", __LINE__);
+
+    static constexpr Key nested_key = "nested"_key;
+    tester.AssertEqual(state.Get(nested_key, value), true, "TestConcurrentObject", __LINE__);
+    tester.AssertEqual(*value.json_val == CreateJson(), true, "TestConcurrentObject", __LINE__);
+
+    std::vector<std::thread> workers;
+    for (s32 thread = 0; thread < 4; ++thread)
+    {
+        workers.emplace_back([&state, thread]()
+        {
+            for (s32 index = 0; index < 1000; ++index)
+            {
+                state.Update("counter" + std::to_string(index % 10), [](JSONValue& counter)
+                {
+                    counter = counter.type == JSONObject::ValueType::INT ? (s32)counter + 1 : 1;
+                });
+                state.Put("thread" + std::to_string(thread) + "_" + std::to_string(index % 50), index);
+
+                JSONValue read;
+                state.Get("counter0", read);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    tester.AssertEqual(state.Size(), (u64)(1 + 10 + 4 * 50), "TestConcurrentObject", __LINE__);
+    JSONObject merged = state.ToObject();
+    s32 total = 0;
+    for (s32 index = 0; index < 10; ++index)
+    {
+        total += (s32)merged["counter" + std::to_string(index)];
+    }
+    tester.AssertEqual(total, 4000, "TestConcurrentObject", __LINE__);
+
+    ConcurrentObject ordered(4, ConcurrentObject::Order::INSERTION);
+    for (s32 index = 0; index < 20; ++index)
+    {
+        ordered.Put("key" + std::to_string(index), index);
+    }
+    ordered.Remove("key5");
+    ordered.Put("key0", 100);
+
+    std::string keys;
+    const JSONObject ordered_obj = ordered.ToObject();
+    for (const JSONObject::Entry<const JSONValue>& entry : ordered_obj)
+    {
+        keys += std::string(entry.key) + ",";
+    }
+    tester.AssertEqual(keys, std::string("key0,key1,key2,key3,key4,key6,key7,key8,key9,key10,key11,key12,"
+                                         "key13,key14,key15,key16,key17,key18,key19,"), "TestConcurrentObject", __LINE__);
+}
+
+void TestTableArray(Tester& tester)
+{
+    JSONArray generic;
+    JSONArray table(JSONArray::Storage::TABLE);
+    for (s32 index = 0; index < 3; ++index)
+    {
+        JSONObject pair;
+        pair.Put("x0", index + 0.5);
+        pair.Put("id", index);
+        pair.Put("name", "pair" + std::to_string(index));
+        generic.PushBack(JSONValue(pair));
+        table.PushBack(JSONValue(std::move(pair)));
+    }
+
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Size(), (u64)3, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Columns().Size(), (u64)3, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Column("x0")->Doubles()[1], 1.5, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Column("id")->Ints()[2], 2, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Column("missing") == nullptr, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Row(2)["name"].str_val, std::string("pair2"), "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Row(2)["missing"].type == JSONObject::ValueType::BAD_TYPE, true, "TestTableArray", __LINE__);
+
+    tester.AssertEqual(table == generic, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Hash(), generic.Hash(), "TestTableArray", __LINE__);
+
+    JSONObject table_json;
+    table_json.Put("pairs", table);
+    JSONObject generic_json;
+    generic_json.Put("pairs", generic);
+    tester.AssertEqual((f64)table_json["pairs"][1]["x0"], 1.5, "TestTableArray", __LINE__);
+
+    JSONSerializer table_serializer;
+    table_serializer.Write(table_json);
+    JSONSerializer generic_serializer;
+    generic_serializer.Write(generic_json);
+    tester.AssertEqual(table_serializer.Str(), generic_serializer.Str(), "TestTableArray", __LINE__);
+
+    CBOREncoder table_encoder;
+    table_encoder.Encode(table_json);
+    CBOREncoder generic_encoder;
+    generic_encoder.Encode(generic_json);
+    tester.AssertEqual(table_encoder.Bytes() == generic_encoder.Bytes(), true, "TestTableArray", __LINE__);
+
+    FrozenDocument frozen = FrozenDocument::Freeze(table_json);
+    tester.AssertEqual(frozen.Root()["pairs"][(u64)2]["name"].AsStr() == "pair2", true, "TestTableArray", __LINE__);
+    tester.AssertEqual(*frozen.Root().Materialize().json_val == generic_json, true, "TestTableArray", __LINE__);
+
+    JSONArray patch;
+    JSONObject test_op;
+    test_op.Put("op", std::string("test"));
+    test_op.Put("path", std::string("/pairs/1/id"));
+    test_op.Put("value", 1);
+    patch.PushBack(JSONValue(std::move(test_op)));
+    tester.AssertEqual(JSONPatch::Apply(table_json, patch), true, "TestTableArray", __LINE__);
+
+    JSONObject row;
+    row.Put("x0", -1.0);
+    row.Put("id", -1);
+    row.Put("name", std::string("first"));
+    table.Insert(0, JSONValue(row));
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.Row(0)["id"].int_val, -1, "TestTableArray", __LINE__);
+
+    JSONValue erased = table.Erase(0);
+    tester.AssertEqual(*erased.json_val == row, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(table == generic, true, "TestTableArray", __LINE__);
+
+    JSONArray converted = generic;
+    tester.AssertEqual(converted.ToTable(), true, "TestTableArray", __LINE__);
+    tester.AssertEqual(converted == generic, true, "TestTableArray", __LINE__);
+    tester.AssertEqual(generic.GetStorage() == JSONArray::Storage::GENERIC, true, "TestTableArray", __LINE__);
+
+    // NOTE(19.10.26): a row with other keys and a reference from At turn the table generic
+    JSONObject other;
+    other.Put("x0", 9.5);
+    converted.PushBack(JSONValue(other));
+    tester.AssertEqual(converted.GetStorage() == JSONArray::Storage::GENERIC, true, "TestTableArray", __LINE__);
+    tester.AssertEqual((f64)converted.At(3)["x0"], 9.5, "TestTableArray", __LINE__);
+    tester.AssertEqual((s32)converted.At(1)["id"], 1, "TestTableArray", __LINE__);
+    tester.AssertEqual(converted.ToTable(), false, "TestTableArray", __LINE__);
+
+    table.At(1)["id"] = 42;
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::GENERIC, true, "TestTableArray", __LINE__);
+    tester.AssertEqual((s32)table.At(1)["id"], 42, "TestTableArray", __LINE__);
+}
+
+static constexpr Key extract_x_key = "x"_key;
+static constexpr Key extract_id_key = "id"_key;
+
+void TestExtractColumn(Tester& tester)
+{
+    JSONArray rows;
+    for (s32 index = 0; index < 6; ++index)
+    {
+        JSONObject row;
+        if (index == 3)
+        {
+            row.Put("extra", 1);
+        }
+        row.Put("x", index + 0.5);
+        row.Put("id", index);
+        rows.PushBack(JSONValue(std::move(row)));
+    }
+
+    std::vector<f64> xs(rows.Size());
+    std::vector<s32> ids(rows.Size());
+    tester.AssertEqual(rows.ExtractColumn(extract_x_key, Span<f64>(xs.data(), xs.size())), true, 
+                       "TestExtractColumn", __LINE__);
+    tester.AssertEqual(xs == std::vector<f64>({0.5, 1.5, 2.5, 3.5, 4.5, 5.5}), true, "TestExtractColumn", __LINE__);
+
+    std::vector<f64> id_nums(rows.Size());
+    Key keys[] = {extract_x_key, extract_id_key};
+    Span<f64> outs[] = {Span<f64>(xs.data(), xs.size()), Span<f64>(id_nums.data(), id_nums.size())};
+    tester.AssertEqual(rows.ExtractColumns(Span<const Key>(keys, 2), Span<const Span<f64>>(outs, 2)), true,
+                       "TestExtractColumn", __LINE__);
+    tester.AssertEqual(id_nums[5], 5.0, "TestExtractColumn", __LINE__);
+
+    // NOTE(19.10.26): doubles are not ints, a missing key or a non object is written as 0
+    tester.AssertEqual(rows.ExtractColumn(extract_x_key, Span<s32>(ids.data(), ids.size())), false, 
+                       "TestExtractColumn", __LINE__);
+    rows.At(2).json_val->Remove("id");
+    rows.PushBack(std::string("not an object"));
+    ids.resize(rows.Size(), -1);
+    tester.AssertEqual(rows.ExtractColumn(extract_id_key, Span<s32>(ids.data(), ids.size())), false, 
+                       "TestExtractColumn", __LINE__);
+    tester.AssertEqual(ids == std::vector<s32>({0, 1, 0, 3, 4, 5, 0}), true, "TestExtractColumn", __LINE__);
+
+    JSONArray table(JSONArray::Storage::TABLE);
+    for (s32 index = 0; index < 4; ++index)
+    {
+        JSONObject row;
+        row.Put("x", index * 2.0);
+        row.Put("id", index);
+        table.PushBack(JSONValue(std::move(row)));
+    }
+    std::vector<f64> table_xs(table.Size());
+    std::vector<f64> table_ids(table.Size());
+    Span<f64> table_outs[] = {Span<f64>(table_xs.data(), table_xs.size()), 
+                              Span<f64>(table_ids.data(), table_ids.size())};
+    tester.AssertEqual(table.ExtractColumns(Span<const Key>(keys, 2), Span<const Span<f64>>(table_outs, 2)), true,
+                       "TestExtractColumn", __LINE__);
+    tester.AssertEqual(table_xs[3] == 6.0 && table_ids[3] == 3.0, true, "TestExtractColumn", __LINE__);
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestExtractColumn", __LINE__);
+
+    // NOTE(19.10.26): more keys than the slot cache holds take a second pass
+    std::vector<std::string> names;
+    for (s32 field = 0; field < 20; ++field)
+    {
+        names.push_back("k" + std::to_string(field));
+    }
+    JSONArray wide;
+    for (s32 index = 0; index < 3; ++index)
+    {
+        JSONObject row;
+        for (s32 field = 0; field < 20; ++field)
+        {
+            row.Put(names[field], index * 100 + field);
+        }
+        wide.PushBack(JSONValue(std::move(row)));
+    }
+    std::vector<Key> wide_keys;
+    std::vector<std::vector<s32>> wide_values(20, std::vector<s32>(wide.Size()));
+    std::vector<Span<s32>> wide_outs;
+    for (s32 field = 0; field < 20; ++field)
+    {
+        wide_keys.push_back(Key(names[field]));
+        wide_outs.push_back(Span<s32>(wide_values[field].data(), wide_values[field].size()));
+    }
+    tester.AssertEqual(wide.ExtractColumns(Span<const Key>(wide_keys.data(), wide_keys.size()), 
+                                           Span<const Span<s32>>(wide_outs.data(), wide_outs.size())), true, 
+                       "TestExtractColumn", __LINE__);
+    tester.AssertEqual(wide_values[19][2], 219, "TestExtractColumn", __LINE__);
+    tester.AssertEqual(wide_values[3][1], 103, "TestExtractColumn", __LINE__);
+}
+
+void TestJSONPath(Tester& tester)
+{
+    JSONObject doc;
+    JSONObject& store = doc.AddObj("store");
+    JSONArray& books = store.AddArr<JSONObject>("book");
+    const char *titles[] = {"a", "b", "c", "d"};
+    for (s32 index = 0; index < 4; ++index)
+    {
+        JSONObject book;
+        book.Put("title", std::string(titles[index]));
+        book.Put("price", index * 10 + 0.5);
+        if (index % 2)
+        {
+            book.Put("isbn", index);
+        }
+        books.PushBack(JSONValue(std::move(book)));
+    }
+    JSONObject bike;
+    bike.Put("price", 19.5);
+    store.Put("bicycle", JSONValue(std::move(bike)));
+    JSONArray& ints = doc.AddArr<s32>("ints");
+    for (s32 index = 0; index < 6; ++index)
+    {
+        ints.PushBack(index);
+    }
+
+    JSONPath path;
+    std::vector<PathValue> out;
+    tester.AssertEqual(path.Compile("$.store.book[1].title"), true, "TestJSONPath", __LINE__);
+    tester.AssertEqual(path.Select(doc, out), (u64)1, "TestJSONPath", __LINE__);
+    tester.AssertEqual(out[0].AsStr() == "b", true, "TestJSONPath", __LINE__);
+
+    out.clear();
+    path.Compile("$['store']['book'][-1].price");
+    path.Select(doc, out);
+    tester.AssertEqual(out.size() == 1 && out[0].AsDouble() == 30.5, true, "TestJSONPath", __LINE__);
+
+    out.clear();
+    path.Compile("$..price");
+    tester.AssertEqual(path.Select(doc, out), (u64)5, "TestJSONPath", __LINE__);
+
+    out.clear();
+    path.Compile("$.store.book[?(@.isbn)].title");
+    path.Select(doc, out);
+    tester.AssertEqual(out.size() == 2 && out[0].AsStr() == "b" && out[1].AsStr() == "d", true, 
+                       "TestJSONPath", __LINE__);
+
+    out.clear();
+    path.Compile("$.store.book[?(@.price < 15 || @.title == 'd')].title");
+    path.Select(doc, out);
+    tester.AssertEqual(out.size() == 3 && out[2].AsStr() == "d", true, "TestJSONPath", __LINE__);
+
+    // NOTE(19.10.26): packed elements are read in place, the array stays packed
+    s32 sum = 0;
+    path.Compile("$.ints[::-2]");
+    path.Run(doc, [&sum](const PathValue& value) { sum = sum * 10 + value.AsInt(); });
+    tester.AssertEqual(sum, 531, "TestJSONPath", __LINE__);
+    path.Compile("$.ints[1:4]");
+    out.clear();
+    path.Select(doc, out);
+    tester.AssertEqual(out.size() == 3 && out[0].GetKind() == PathValue::Kind::ELEMENT, true, 
+                       "TestJSONPath", __LINE__);
+    tester.AssertEqual(out[2].Copy() == JSONValue(3), true, "TestJSONPath", __LINE__);
+    tester.AssertEqual(doc["ints"].json_arr.GetStorage() == JSONArray::Storage::INTS, true, "TestJSONPath", __LINE__);
+
+    // NOTE(19.10.26): one plan over a generic and a TABLE copy of the same rows
+    JSONPath filter;
+    tester.AssertEqual(filter.Compile("$.store.book[?(@.price >= 10 && @.price <= 21)].price"), true, 
+                       "TestJSONPath", __LINE__);
+    JSONObject table_doc;
+    JSONArray& rows = table_doc.AddObj("store").AddArr<JSONObject>("book");
+    for (s32 index = 0; index < 4; ++index)
+    {
+        JSONObject row;
+        row.Put("title", std::string(titles[index]));
+        row.Put("price", index * 10 + 0.5);
+        rows.PushBack(JSONValue(std::move(row)));
+    }
+    rows.ToTable();
+    for (const JSONObject *target : {&doc, &table_doc})
+    {
+        f64 total = 0;
+        filter.Run(*target, [&total](const PathValue& price) { total += price.AsDouble(); });
+        tester.AssertEqual(total, 31.0, "TestJSONPath", __LINE__);
+    }
+    const JSONArray& table = table_doc["store"]["book"].json_arr;
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestJSONPath", __LINE__);
+
+    out.clear();
+    path.Compile("$.store.book[2]");
+    path.Select(table_doc, out);
+    tester.AssertEqual(out.size() == 1 && out[0].GetKind() == PathValue::Kind::ROW, true, "TestJSONPath", __LINE__);
+    tester.AssertEqual((f64)out[0].Copy()["price"], 20.5, "TestJSONPath", __LINE__);
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestJSONPath", __LINE__);
+
+    tester.AssertEqual(path.Compile("store.book"), false, "TestJSONPath", __LINE__);
+    tester.AssertEqual(path.Compile("$.store[1:2:0]"), false, "TestJSONPath", __LINE__);
+    tester.AssertEqual(path.Compile("$[?(@.a == )]"), false, "TestJSONPath", __LINE__);
+    tester.AssertEqual(path.Good(), false, "TestJSONPath", __LINE__);
+}
+
+static constexpr Key aggregate_x_key = "x"_key;
+
+void TestAggregate(Tester& tester)
+{
+    JSONArray doubles(JSONArray::Storage::DOUBLES);
+    JSONArray ints(JSONArray::Storage::INTS);
+    u32 seed = 7;
+    for (s32 index = 0; index < 1003; ++index)
+    {
+        seed = seed * 1103515245 + 12345;
+        doubles.PushBack((f64)(seed >> 8) / (1 << 20) - 4000.0);
+        ints.PushBack((s32)(seed >> 4) - (1 << 27));
+    }
+
+    // NOTE(19.10.26): both kernels add in the same lanes, the sums are the same bits
+    for (const JSONArray *arr : {&doubles, &ints})
+    {
+        Summary scalar = Summarize(*arr, AggregateKernel::SCALAR);
+        Summary best = Summarize(*arr, AggregateKernel::BEST);
+        tester.AssertEqual(scalar.count, (u64)1003, "TestAggregate", __LINE__);
+        tester.AssertEqual(scalar.sum == best.sum && scalar.min == best.min && scalar.max == best.max, true,
+                           "TestAggregate", __LINE__);
+    }
+
+    s64 int_sum = 0;
+    s32 int_min = std::numeric_limits<s32>::max();
+    for (s32 num : ints.Ints())
+    {
+        int_sum += num;
+        int_min = std::min(int_min, num);
+    }
+    Summary ints_summary = Summarize(ints);
+    tester.AssertEqual(ints_summary.sum == (f64)int_sum && ints_summary.min == int_min, true, "TestAggregate", __LINE__);
+    tester.AssertEqual(ints.GetStorage() == JSONArray::Storage::INTS, true, "TestAggregate", __LINE__);
+
+    JSONArray mixed;
+    mixed.PushBack(1);
+    mixed.PushBack(2.5);
+    mixed.PushBack(std::string("three"));
+    mixed.PushBack(4);
+    Summary mixed_summary = Summarize(mixed);
+    tester.AssertEqual(mixed_summary.count, (u64)3, "TestAggregate", __LINE__);
+    tester.AssertEqual(mixed_summary.Mean(), 2.5, "TestAggregate", __LINE__);
+    tester.AssertEqual(mixed_summary.max, 4.0, "TestAggregate", __LINE__);
+
+    Summary empty = Summarize(JSONArray(JSONArray::Storage::DOUBLES));
+    tester.AssertEqual(empty.count == 0 && empty.min > empty.max && empty.Mean() == 0, true, "TestAggregate", __LINE__);
+
+    JSONArray rows;
+    for (s32 index = 0; index < 10; ++index)
+    {
+        JSONObject row;
+        row.Put("x", index);
+        rows.PushBack(JSONValue(std::move(row)));
+    }
+    JSONArray table = rows;
+    table.ToTable();
+    rows.PushBack(std::string("not a row"));
+    for (const JSONArray *arr : {&rows, &table})
+    {
+        Summary x = Summarize(*arr, aggregate_x_key);
+        tester.AssertEqual(x.count == 10 && x.sum == 45 && x.min == 0 && x.max == 9, true, "TestAggregate", __LINE__);
+
+        u64 bins[5] = {};
+        tester.AssertEqual(Histogram(*arr, aggregate_x_key, 0, 9, Span<u64>(bins, 5)), (u64)9, "TestAggregate", __LINE__);
+        tester.AssertEqual(bins[0] == 2 && bins[2] == 2 && bins[4] == 1, true, "TestAggregate", __LINE__);
+    }
+    tester.AssertEqual(Summarize(rows, "y"_key).count, (u64)0, "TestAggregate", __LINE__);
+
+    u64 scalar_bins[64] = {};
+    u64 best_bins[64] = {};
+    u64 scalar_counted = Histogram(doubles, -3000, 3000, Span<u64>(scalar_bins, 64), AggregateKernel::SCALAR);
+    u64 best_counted = Histogram(doubles, -3000, 3000, Span<u64>(best_bins, 64), AggregateKernel::BEST);
+    tester.AssertEqual(scalar_counted, best_counted, "TestAggregate", __LINE__);
+    tester.AssertEqual(std::equal(scalar_bins, scalar_bins + 64, best_bins), true, "TestAggregate", __LINE__);
+    tester.AssertEqual(Histogram(ints, 1, 1, Span<u64>(best_bins, 64)), (u64)0, "TestAggregate", __LINE__);
+}
+
+static constexpr Key index_id_key = "id"_key;
+static constexpr Key index_name_key = "name"_key;
+
+static JSONValue IndexRow(s32 id)
+{
+    JSONObject row;
+    row.Put("id", id);
+    row.Put("name", "row" + std::to_string(id));
+    return JSONValue(std::move(row));
+}
+
+void TestArrayIndex(Tester& tester)
+{
+    JSONArray rows;
+    for (s32 id = 0; id < 100; ++id)
+    {
+        rows.PushBack(IndexRow(id));
+    }
+    rows.PushBack(std::string("not a row"));
+
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42)), (s64)42, "TestArrayIndex", __LINE__);
+    JSONArray::IndexStats stats = rows.BuildIndex("id");
+    tester.AssertEqual(stats.entries, (u64)100, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(stats.bytes > 0, true, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42)), (s64)42, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42.0)), (s64)-1, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(1000)), (s64)-1, "TestArrayIndex", __LINE__);
+
+    // NOTE(19.10.26): PushBack, Insert and Erase keep the positions up to date
+    rows.PushBack(IndexRow(100));
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(100)), (s64)101, "TestArrayIndex", __LINE__);
+    rows.Erase(10);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(10)), (s64)-1, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42)), (s64)41, "TestArrayIndex", __LINE__);
+    rows.Insert(0, IndexRow(500));
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(500)), (s64)0, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42)), (s64)42, "TestArrayIndex", __LINE__);
+    rows.Insert(5, IndexRow(42));
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(42)), (s64)5, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.GetIndexStats("id").entries, (u64)102, "TestArrayIndex", __LINE__);
+
+    // NOTE(19.10.26): a write through At is not followed, the next Find rebuilds
+    rows.At(1)["id"] = 9999;
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(9999)), (s64)1, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(0)), (s64)-1, "TestArrayIndex", __LINE__);
+
+    JSONArray copy = rows;
+    copy.PushBack(IndexRow(777));
+    tester.AssertEqual(copy.Find(index_id_key, JSONValue(777)), (s64)103, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(777)), (s64)-1, "TestArrayIndex", __LINE__);
+
+    rows.BuildIndex("name");
+    tester.AssertEqual(rows.Find(index_name_key, JSONValue(std::string("row7"))), (s64)9, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.DropIndex("name"), true, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.DropIndex("name"), false, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.GetIndexStats("name").entries, (u64)0, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(rows.Find(index_name_key, JSONValue(std::string("row7"))), (s64)9, "TestArrayIndex", __LINE__);
+
+    JSONArray table;
+    for (s32 id = 0; id < 10; ++id)
+    {
+        table.PushBack(IndexRow(id * 3));
+    }
+    table.BuildIndex("id");
+    table.ToTable();
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(table.Find(index_id_key, JSONValue(27)), (s64)9, "TestArrayIndex", __LINE__);
+    table.PushBack(IndexRow(30));
+    tester.AssertEqual(table.Find(index_id_key, JSONValue(30)), (s64)10, "TestArrayIndex", __LINE__);
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestArrayIndex", __LINE__);
+
+    // NOTE(19.10.26): readers of a stale index race to rebuild it, one of them does
+    rows.At(2)["id"] = 8888;
+    const JSONArray& shared = rows;
+    std::atomic<u64> found(0);
+    std::vector<std::thread> readers;
+    for (u64 reader = 0; reader < 4; ++reader)
+    {
+        readers.emplace_back([&shared, &found]()
+        {
+            found += shared.Find(index_id_key, JSONValue(8888)) == 2;
+        });
+    }
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    tester.AssertEqual(found.load(), (u64)4, "TestArrayIndex", __LINE__);
+}
+
+void TestRemoveIf(Tester& tester)
+{
+    JSONArray ints;
+    for (s32 num = 0; num < 10; ++num)
+    {
+        ints.PushBack(num);
+    }
+    JSONArray ints_copy = ints;
+    u64 removed = ints.RemoveIf([](const JSONValue& num) { return num.int_val % 2 == 1; });
+    tester.AssertEqual(removed, (u64)5, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.GetStorage() == JSONArray::Storage::INTS, true, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.ValueAt(3).int_val, 6, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints_copy.Size(), (u64)10, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.RemoveIf([](const JSONValue&) { return false; }), (u64)0, "TestRemoveIf", __LINE__);
+
+    const u64 ends[] = {0, 4};
+    tester.AssertEqual(ints.EraseIndices(Span<const u64>(ends, 2)), (u64)2, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.Size(), (u64)3, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.ValueAt(0).int_val, 2, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(ints.ValueAt(2).int_val, 6, "TestRemoveIf", __LINE__);
+
+    // NOTE(19.10.26): unsorted, repeated and out of range indices
+    JSONArray messy;
+    for (s32 num = 0; num < 6; ++num)
+    {
+        messy.PushBack(num);
+    }
+    const u64 messy_indices[] = {4, 1, 4, 99, 1};
+    tester.AssertEqual(messy.EraseIndices(Span<const u64>(messy_indices, 5)), (u64)2, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(messy.Size(), (u64)4, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(messy.ValueAt(1).int_val, 2, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(messy.ValueAt(3).int_val, 5, "TestRemoveIf", __LINE__);
+    const u64 out_of_range[] = {4};
+    tester.AssertEqual(messy.EraseIndices(Span<const u64>(out_of_range, 1)), (u64)0, "TestRemoveIf", __LINE__);
+
+    JSONArray doubles;
+    for (s32 num = 0; num < 6; ++num)
+    {
+        doubles.PushBack(num * 0.5);
+    }
+    doubles.RemoveIf([](const JSONValue& num) { return num.double_val >= 2.0; });
+    tester.AssertEqual(doubles.Size(), (u64)4, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(doubles.GetStorage() == JSONArray::Storage::DOUBLES, true, "TestRemoveIf", __LINE__);
+
+    // NOTE(19.10.26): the removed rows own objects and strings, ASan reports them if 
+    // they are not released
+    JSONArray rows;
+    for (s32 id = 0; id < 30; ++id)
+    {
+        rows.PushBack(IndexRow(id));
+    }
+    rows.BuildIndex("id");
+    removed = rows.RemoveIf([](const JSONValue& row) { return row[index_id_key].int_val % 3 == 0; });
+    tester.AssertEqual(removed, (u64)10, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(3)), (s64)-1, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(29)), (s64)19, "TestRemoveIf", __LINE__);
+
+    const u64 firsts[] = {0, 1, 2};
+    rows.EraseIndices(Span<const u64>(firsts, 3));
+    tester.AssertEqual(rows.Size(), (u64)17, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(rows.At(0)["name"].str_val, std::string("row5"), "TestRemoveIf", __LINE__);
+    tester.AssertEqual(rows.Find(index_id_key, JSONValue(29)), (s64)16, "TestRemoveIf", __LINE__);
+
+    JSONArray table;
+    for (s32 id = 0; id < 10; ++id)
+    {
+        table.PushBack(IndexRow(id));
+    }
+    table.ToTable();
+    const u64 odds[] = {1, 3, 5, 7, 9};
+    tester.AssertEqual(table.EraseIndices(Span<const u64>(odds, 5)), (u64)5, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(table.GetStorage() == JSONArray::Storage::TABLE, true, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(table.Row(4)[index_id_key].int_val, 8, "TestRemoveIf", __LINE__);
+    table.RemoveIf([](const JSONValue& row) { return row[index_name_key].str_val == "row4"; });
+    tester.AssertEqual(table.Size(), (u64)4, "TestRemoveIf", __LINE__);
+    tester.AssertEqual(table.At(2)["id"].int_val, 6, "TestRemoveIf", __LINE__);
+}
+
 int main(int argc, char *argv[])
 {
 	Tester tester;
@@ -159,6 +1690,48 @@ int main(int argc, char *argv[])
 
     TestPutJSONObject(tester);
 
+    TestJSONArrayDeepCopy(tester);
+
+    TestJSONArrayErase(tester);
+
+    TestPackedArrays(tester);
+
+    TestMoveDoesNotAllocate(tester);
+
+    TestEmplace(tester);
+
+    TestSnapshotSharing(tester);
+
+    TestKeyLookup(tester);
+
+    TestStaticKey(tester);
+
+    TestSerializer(tester);
+
+    TestNumberFormat(tester);
+
+    TestJSONWriter(tester);
+
+    TestCBOR(tester);
+
+    TestSnapshot(tester);
+
+    TestStructuralHash(tester);
+
+    TestRemove(tester);
+    TestRemoveChurn(tester);
+    TestMemberIteration(tester);
+    TestReclaimer(tester);
+    TestJSONPatch(tester);
+    TestFrozenDocument(tester);
+    TestConcurrentObject(tester);
+    TestTableArray(tester);
+    TestExtractColumn(tester);
+    TestJSONPath(tester);
+    TestAggregate(tester);
+    TestArrayIndex(tester);
+    TestRemoveIf(tester);
+
     tester.TestAll();
 
 	return 0;
@@ -10,6 +10,7 @@
 #include <fstream>
 #include <list>
 
+#include "Deduplicator.h"
 #include "JSONObject.h"
 #include "my_int.h"
 
@@ -17,9 +18,7 @@ namespace JSORON
 {
     class JSONParser 
     {
-#ifndef NDEBUG
     public:
-#endif /* NDEBUG */    
         enum class TokenType
         {
             NULL_TYPE,
@@ -68,9 +67,17 @@ namespace JSORON
     
     public:
         typedef std::list<Token> TokenList;
+
+        JSONParser() : dedup(nullptr) {}
            
-        JSONObject& Parse(const std::string& json_str);
-        JSONObject& Parse(std::ifstream& json_file); 
+        JSONObject Parse(const std::string& json_str);
+        JSONObject Parse(std::ifstream& json_file); 
+
+        /**
+         * @brief parses with identical objects and arrays sharing one body, see Deduplicator.
+         *        dedup can be reused across documents to share between them too
+         */
+        JSONObject Parse(const std::string& json_str, Deduplicator& dedup);
         
         friend bool operator==(const JSONParser& lhs, const JSONParser& rhs);
         friend bool operator!=(const JSONParser& lhs, const JSONParser& rhs);
@@ -84,18 +91,33 @@ namespace JSORON
         void Lex(const std::string& json_str);
 
         void LexPunctuation(const char punc);
+
+        /**
+         * @brief lexes the string starting at at, decoding its escapes
+         * @return number of characters consumed, up to the closing quote
+         */
         u32 LexString(const std::string& json_str, u32 at);
+
+        /**
+         * @brief reads the 4 hex digits of a u escape, and the low surrogate after a high one
+         * @return number of characters consumed
+         */
+        static u32 LexCodePoint(const std::string& json_str, u32 at, u32& code_point);
+        static u32 LexHex(const std::string& json_str, u32 at, u32& value);
+        static void AppendUTF8(std::string& str, u32 code_point);
+
         u8 LexNumber(const std::string& json_str, u32 at);
 
         b8 IsEndOfObj(const Token& tok);
         b8 IsEndOfArr(const Token& tok);
 
-        JSONObject::JSONValue *_Parse();
-        JSONObject::JSONValue *ParseObj();
-        JSONObject::JSONValue *ParseArray();
+        JSONObject::JSONValue _Parse();
+        JSONObject::JSONValue ParseObj();
+        JSONObject::JSONValue ParseArray();
 
         TokenList::iterator curr_tok;
         TokenList tokens;
+        Deduplicator *dedup;
     };
 }
 
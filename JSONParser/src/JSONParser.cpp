@@ -4,6 +4,7 @@
 /* Author:   Oron                            */ 
 /* ------------------------------------------*/
 
+#include <cstdlib>
 #include <fstream>
 #include <string>
 #include <list>
@@ -85,7 +86,7 @@ namespace JSORON
     
     const JSONObject JSONParser::bad_obj = JSONObject();
     
-    JSONObject& JSONParser::Parse(std::ifstream& json_file)
+    JSONObject JSONParser::Parse(std::ifstream& json_file)
     {
 	    u64 file_size = 0;
 	    json_file.seekg(0, std::ios_base::end);
@@ -97,22 +98,38 @@ namespace JSORON
         json_file.read(&json_str[0], file_size);
 	    if (json_file.fail())
         {
-            return *(new JSONObject());
+            return JSONObject();
         }
 
         return Parse(json_str); 
     }
     
-    JSONObject& JSONParser::Parse(const std::string& json_str)
+    JSONObject JSONParser::Parse(const std::string& json_str)
     {
         // Profiler_TimeFunction; // NOTE(27.10.24): PROFILING
 
         Lex(json_str);
         curr_tok = tokens.begin();
-        return *(_Parse()->json_val);
+
+        JSONValue root = _Parse();
+        if (root.type != JSONObject::ValueType::JSON_OBJECT)
+        {
+            return JSONObject();
+        }
+
+        return std::move(*root.json_val);
+    }
+
+    JSONObject JSONParser::Parse(const std::string& json_str, Deduplicator& dedup)
+    {
+        this->dedup = &dedup;
+        JSONObject obj = Parse(json_str);
+        this->dedup = nullptr;
+
+        return obj;
     }
 
-    JSONObject::JSONValue *JSONParser::_Parse()
+    JSONObject::JSONValue JSONParser::_Parse()
     {
         // Profiler_TimeFunction; // NOTE(23.10.24): PROFILING
 
@@ -128,7 +145,7 @@ namespace JSORON
             }
             else 
             {
-                return new JSONValue();
+                return JSONValue();
             }
         }
 
@@ -136,12 +153,12 @@ namespace JSORON
         {
             case TokenType::DOUBLE:
             {
-                return new JSONValue(curr_tok->double_tok);
+                return JSONValue(curr_tok->double_tok);
             } break;
 
             case TokenType::INT:
             {
-                return new JSONValue(curr_tok->int_tok);
+                return JSONValue(curr_tok->int_tok);
             } break;
 
             case TokenType::STR:
@@ -150,48 +167,53 @@ namespace JSORON
                 if (curr_tok_next->type == TokenType::PUNCTUATION &&
                     curr_tok_next->punc_tok == ':')
                 {
-                    return new JSONValue(JSONObject::ValueType::KEY, curr_tok->str_tok);
+                    return JSONValue(JSONObject::ValueType::KEY, curr_tok->str_tok);
                 }
                 else
                 {
-                    return new JSONValue(curr_tok->str_tok);
+                    return JSONValue(curr_tok->str_tok);
                 }
             } break;
         }
 
-        return new JSONValue(JSONObject::ValueType::BAD_TYPE);
+        return JSONValue(JSONObject::ValueType::BAD_TYPE);
     }
     
-    JSONObject::JSONValue *JSONParser::ParseObj()
+    JSONObject::JSONValue JSONParser::ParseObj()
     {
         Profiler_TimeFunction; // NOTE(23.10.24): PROFILING
 
-        JSONValue *obj = new JSONValue(new JSONObject());
+        JSONValue obj(JSONObject{});
         
         ++curr_tok;
 
         while (!IsEndOfObj(*curr_tok))
         {
-            JSONValue *key = _Parse();
-            if (key->type == JSONObject::ValueType::KEY)
+            JSONValue key = _Parse();
+            if (key.type == JSONObject::ValueType::KEY)
             {
                 ++curr_tok;
                 ++curr_tok;
 
-                JSONValue *val = _Parse();
-                if (val->type == JSONObject::ValueType::NULL_TYPE ||
-                    val->type == JSONObject::ValueType::BAD_TYPE)
+                JSONValue val = _Parse();
+                if (val.type == JSONObject::ValueType::NULL_TYPE ||
+                    val.type == JSONObject::ValueType::BAD_TYPE)
                 {
-                    std::cerr << "Invalid value for key " << key->str_val << "\n";
+                    std::cerr << "Invalid value for key " << key.str_val << "\n";
                     break;
                 }
 
-                obj->json_val->Put(key->str_val, val); 
+                obj.json_val->Put(std::move(key.str_val), std::move(val)); 
             }
 
             ++curr_tok;
         }
 
+        if (dedup)
+        {
+            dedup->Intern(obj);
+        }
+
         return obj;
     }
 
@@ -206,25 +228,30 @@ namespace JSORON
         return 0;
     }
 
-    JSONObject::JSONValue *JSONParser::ParseArray()
+    JSONObject::JSONValue JSONParser::ParseArray()
     {
         Profiler_TimeFunction; // NOTE(23.10.24): PROFILING
 
-        JSONValue *arr = new JSONValue(*(new JSONArray()));
+        JSONValue arr(JSONArray{});
 
         ++curr_tok;
 
         while (!IsEndOfArr(*curr_tok))
         {
-            JSONValue *val = _Parse();
-            if (val->type != JSONObject::ValueType::NULL_TYPE)
+            JSONValue val = _Parse();
+            if (val.type != JSONObject::ValueType::NULL_TYPE)
             {
-                arr->json_arr.PushBack(val);
+                arr.json_arr.PushBack(std::move(val));
             }
         
             ++curr_tok;
         }
 
+        if (dedup)
+        {
+            dedup->Intern(arr);
+        }
+
         return arr;
     }
     
@@ -242,6 +269,9 @@ namespace JSORON
     void JSONParser::Lex(const std::string& json_str)
     {
         // Profiler_TimeFunction; // NOTE(25.09.24): PROFILING
+
+        // NOTE(19.10.26): a parser can be reused, the tokens of the last document must go
+        tokens.clear();
         
         for (u32 at = 0; at < json_str.size();)
         {
@@ -254,6 +284,15 @@ namespace JSORON
                 continue;
             } 
 
+            // NOTE(19.10.26): a string is everything up to the closing quote, it can start
+            // with a digit, a space or punctuation, JSON Pointers in a patch start with '/'
+            if (json_str[at] == '"')
+            {
+                at += LexString(json_str, at + 1) + 2;
+
+                continue;
+            }
+
             if (std::ispunct(json_str[at]))
             {
                 LexPunctuation(json_str[at]);
@@ -332,18 +371,125 @@ namespace JSORON
 
         std::string str;
 
+        // NOTE(19.10.26): runs without a backslash are copied at once, an escaped quote 
+        // does not end the string and the escapes the serializer writes are decoded
         u32 string_start = at;
-        while (json_str[at] != '"')
+        u32 run = at;
+        while (at < json_str.size() && json_str[at] != '"')
         {
-            ++at;
+            if (json_str[at] != '\\' || at + 1 >= json_str.size())
+            {
+                ++at;
+                continue;
+            }
+
+            str.append(json_str, run, at - run);
+            char escape = json_str[at + 1];
+            at += 2;
+            switch (escape)
+            {
+                case 'b':
+                {
+                    str += '\b';
+                } break;
+
+                case 'f':
+                {
+                    str += '\f';
+                } break;
+
+                case 'n':
+                {
+                    str += '\n';
+                } break;
+
+                case 'r':
+                {
+                    str += '\r';
+                } break;
+
+                case 't':
+                {
+                    str += '\t';
+                } break;
+
+                case 'u':
+                {
+                    u32 code_point = 0;
+                    at += LexCodePoint(json_str, at, code_point);
+                    AppendUTF8(str, code_point);
+                } break;
+
+                default:
+                {
+                    // NOTE(19.10.26): '"', '\\' and '/' stand for themselves
+                    str += escape;
+                } break;
+            }
+            run = at;
         }
 
-        u32 count = at - string_start; 
-        str.insert(0, json_str, string_start, count);
+        str.append(json_str, run, at - run);
         tokens.push_back(Token(str));
 
+        return at - string_start;
+    }
+
+    u32 JSONParser::LexCodePoint(const std::string& json_str, u32 at, u32& code_point)
+    {
+        u32 count = LexHex(json_str, at, code_point);
+
+        // NOTE(19.10.26): a code point above the BMP is escaped as a high and a low surrogate
+        u32 low = 0;
+        if (code_point >= 0xD800 && code_point < 0xDC00 && count == 4 && 
+            at + 6 <= json_str.size() && json_str[at + 4] == '\\' && json_str[at + 5] == 'u' && 
+            LexHex(json_str, at + 6, low) == 4 && low >= 0xDC00 && low < 0xE000)
+        {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            count += 6;
+        }
+
+        return count;
+    }
+
+    u32 JSONParser::LexHex(const std::string& json_str, u32 at, u32& value)
+    {
+        value = 0;
+        u32 count = 0;
+        for (; count < 4 && at + count < json_str.size() && std::isxdigit((u8)json_str[at + count]); ++count)
+        {
+            char digit = json_str[at + count];
+            value = value * 16 + (std::isdigit((u8)digit) ? digit - '0' : (std::tolower((u8)digit) - 'a' + 10));
+        }
+
         return count;
     }
+
+    void JSONParser::AppendUTF8(std::string& str, u32 code_point)
+    {
+        if (code_point < 0x80)
+        {
+            str += (char)code_point;
+        }
+        else if (code_point < 0x800)
+        {
+            str += (char)(0xC0 | (code_point >> 6));
+            str += (char)(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000)
+        {
+            str += (char)(0xE0 | (code_point >> 12));
+            str += (char)(0x80 | ((code_point >> 6) & 0x3F));
+            str += (char)(0x80 | (code_point & 0x3F));
+        }
+        else
+        {
+            str += (char)(0xF0 | (code_point >> 18));
+            str += (char)(0x80 | ((code_point >> 12) & 0x3F));
+            str += (char)(0x80 | ((code_point >> 6) & 0x3F));
+            str += (char)(0x80 | (code_point & 0x3F));
+        }
+    }
     
     u8 JSONParser::LexNumber(const std::string& json_str, u32 at)
     {
@@ -351,6 +497,7 @@ namespace JSORON
 
         std::string num;
         b8 is_float = 0;
+        b8 has_exponent = 0;
 
         u64 index = at;
         s8 sign = 1;
@@ -380,6 +527,19 @@ namespace JSORON
                 }
             }
 
+            // NOTE(19.10.26): exponents, as the serializer writes them for very big and small doubles
+            if ((json_str[index] == 'e' || json_str[index] == 'E') && !has_exponent)
+            {
+                is_float = 1;
+                has_exponent = 1;
+                if (json_str[index + 1] == '+' || json_str[index + 1] == '-')
+                {
+                    num += json_str[index];
+                    ++index;
+                }
+                continue;
+            }
+
             if (!std::isdigit(json_str[index]))
             {
                 break;
@@ -388,7 +548,8 @@ namespace JSORON
 
         if (is_float)
         {
-            f64 new_float = std::stod(num);
+            // NOTE(19.10.26): strtod, stod throws on subnormals
+            f64 new_float = std::strtod(num.c_str(), nullptr);
             new_float *= sign;
             tokens.push_back(Token(new_float));
         }
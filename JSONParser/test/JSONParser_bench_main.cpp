@@ -0,0 +1,184 @@
+/* ------------------------------------------*/ 
+/* Filename: JSONParser_bench_main.cpp       */
+/* Date:     19.10.2026                      */
+/* Author:   Oron                            */ 
+/* ------------------------------------------*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "CBOR.h"
+#include "Deduplicator.h"
+#include "JSONObject.h"
+#include "JSONParser.h"
+#include "JSONSerializer.h"
+#include "Snapshot.h"
+
+using namespace JSORON;
+
+typedef std::chrono::steady_clock Clock;
+
+static f64 MillisecondsSince(Clock::time_point start)
+{
+    std::chrono::duration<f64, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+static void PrintResult(const char *name, f64 ms, u64 num_bytes)
+{
+    std::cout << name << ": " << ms << " ms, " << num_bytes << " bytes, " 
+              << num_bytes / (ms / 1000) / (1024 * 1024) << " MB/s\n";
+}
+
+JSONObject CreatePairsDoc(u64 num_pairs)
+{
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<f64> x_dist(-180.0, 180.0);
+    std::uniform_real_distribution<f64> y_dist(-90.0, 90.0);
+
+    JSONArray pairs;
+    pairs.Reserve(num_pairs);
+    for (u64 index = 0; index < num_pairs; ++index)
+    {
+        JSONObject pair;
+        pair.Put("x0", x_dist(rng));
+        pair.Put("y0", y_dist(rng));
+        pair.Put("x1", x_dist(rng));
+        pair.Put("y1", y_dist(rng));
+        pairs.PushBack(JSONValue(std::move(pair)));
+    }
+
+    JSONObject doc;
+    doc.Put("pairs", std::move(pairs));
+
+    return doc;
+}
+
+void BenchTextVsCBOR(const JSONObject& doc)
+{
+    Clock::time_point start = Clock::now();
+    JSONSerializer serializer;
+    serializer.Write(doc);
+    std::string text = serializer.Str();
+    PrintResult("text encode (JSONSerializer)", MillisecondsSince(start), text.size());
+
+    start = Clock::now();
+    JSONParser parser;
+    JSONObject from_text = parser.Parse(text);
+    PrintResult("text decode (JSONParser)", MillisecondsSince(start), text.size());
+
+    start = Clock::now();
+    CBOREncoder encoder;
+    encoder.Encode(doc);
+    PrintResult("cbor encode (CBOREncoder)", MillisecondsSince(start), encoder.Bytes().size());
+
+    start = Clock::now();
+    CBORDecoder decoder;
+    JSONObject from_cbor = decoder.Decode(encoder.Bytes());
+    PrintResult("cbor decode (CBORDecoder)", MillisecondsSince(start), encoder.Bytes().size());
+
+    std::cout << "round trips equal: text " << (from_text == doc) << ", cbor " << (from_cbor == doc) << "\n";
+}
+
+void BenchSnapshotStartup(const JSONObject& doc)
+{
+    const char *text_path = "/tmp/jsoron_bench.json";
+    const char *snapshot_path = "/tmp/jsoron_bench.snap";
+
+    JSONSerializer serializer;
+    serializer.Write(doc);
+    std::ofstream(text_path, std::ios::binary) << serializer.View();
+
+    SnapshotWriter writer;
+    writer.Write(doc);
+    writer.WriteToFile(snapshot_path);
+
+    Clock::time_point start = Clock::now();
+    std::ifstream text_file(text_path, std::ios::binary);
+    JSONParser parser;
+    JSONObject parsed = parser.Parse(text_file);
+    f64 text_ms = MillisecondsSince(start);
+
+    f64 sum = 0;
+    for (const JSONValue& pair : parsed["pairs"].json_arr)
+    {
+        sum += (f64)pair["x0"];
+    }
+    std::cout << "open text + parse: " << text_ms << " ms (checksum " << sum << ")\n";
+
+    start = Clock::now();
+    Snapshot snapshot;
+    snapshot.Open(snapshot_path);
+    f64 snapshot_ms = MillisecondsSince(start);
+
+    start = Clock::now();
+    sum = 0;
+    SnapshotValue pairs = snapshot.Root()["pairs"];
+    for (u64 index = 0; index < pairs.Size(); ++index)
+    {
+        sum += pairs[index]["x0"].AsDouble();
+    }
+    f64 scan_ms = MillisecondsSince(start);
+    std::cout << "open snapshot: " << snapshot_ms << " ms, first scan of every x0: " << scan_ms 
+              << " ms (checksum " << sum << ", " << writer.Bytes().size() << " bytes)\n";
+
+    std::remove(text_path);
+    std::remove(snapshot_path);
+}
+
+void BenchDedup(u64 num_records)
+{
+    const char *statuses[] = {"active", "suspended", "closed"};
+    const char *countries[] = {"DE", "FR", "IL", "US"};
+
+    std::mt19937_64 rng(2024);
+    std::string json_str = "{\"records\": [";
+    for (u64 index = 0; index < num_records; ++index)
+    {
+        json_str += index ? ", " : "";
+        json_str += "{\"id\": " + std::to_string(index) + ", \"meta\": {\"status\": \"" + 
+                    statuses[rng() % 3] + "\", \"country\": \"" + countries[rng() % 4] + 
+                    "\", \"limits\": [100, 200, 300]}}";
+    }
+    json_str += "]}";
+
+    JSONParser parser;
+    Clock::time_point start = Clock::now();
+    JSONObject plain = parser.Parse(json_str);
+    std::cout << "parse: " << MillisecondsSince(start) << " ms\n";
+
+    Deduplicator dedup;
+    start = Clock::now();
+    JSONObject deduped = parser.Parse(json_str, dedup);
+    f64 dedup_ms = MillisecondsSince(start);
+
+    const Deduplicator::Stats& stats = dedup.GetStats();
+    std::cout << "parse with dedup: " << dedup_ms << " ms, " << stats.containers_shared << "/" 
+              << stats.containers_seen << " containers shared, " << stats.bytes_saved << " bytes saved\n";
+}
+
+int main(int argc, char *argv[])
+{
+    u64 num_pairs = 100000;
+    if (argc > 1)
+    {
+        num_pairs = std::stoull(argv[1]);
+    }
+
+    JSONObject doc = CreatePairsDoc(num_pairs);
+
+    std::cout << "--- text vs cbor, " << num_pairs << " haversine pairs ---\n";
+    BenchTextVsCBOR(doc);
+
+    std::cout << "--- startup, text vs snapshot, " << num_pairs << " haversine pairs ---\n";
+    BenchSnapshotStartup(doc);
+
+    std::cout << "--- dedup, " << num_pairs << " records with repeated sub-objects ---\n";
+    BenchDedup(num_pairs);
+
+    return 0;
+}
@@ -5,11 +5,15 @@
 /* ------------------------------------------*/
 
 #include <vector>
+#include <random>
+#include <cstring>
 #include <list>
 #include <iostream>
 
 #include "JSONParser.h"
 #include "JSONObject.h"
+#include "JSONPatch.h"
+#include "JSONSerializer.h"
 #include "generic_test.h"
 
 using namespace JSORON;
@@ -37,6 +41,13 @@ void TestRealJson_Parse(Tester& tester);
 
 void TestParseFromFile(Tester& tester);
 
+void TestParsePackedArrays(Tester& tester);
+
+void TestSerializeRoundTrip(Tester& tester);
+void TestDoubleRoundTrip(Tester& tester);
+void TestParseDedup(Tester& tester);
+void TestParsePatch(Tester& tester);
+
 void PrintTokenList(JSONParser::TokenList token_list);
 
 int main(int argc, char *argv[])
@@ -56,6 +67,13 @@ int main(int argc, char *argv[])
 
     TestParseFromFile(tester);
 
+    TestParsePackedArrays(tester);
+
+    TestSerializeRoundTrip(tester);
+    TestDoubleRoundTrip(tester);
+    TestParseDedup(tester);
+    TestParsePatch(tester);
+
     tester.TestAll();
 
 	return 0;
@@ -84,6 +102,165 @@ void TestParseFromFile(Tester& tester)
     }
 }
 
+void TestParsePackedArrays(Tester& tester)
+{
+    JSONParser parser;
+    JSONObject obj = parser.Parse("{ \"ints\": [1, -2, 3], \"doubles\": [1.5, -2.25], \"mixed\": [1, 2.5] }");
+
+    const JSONArray& ints = obj["ints"];
+    tester.AssertEqual(ints.GetStorage() == JSONArray::Storage::INTS, true, "TestParsePackedArrays", __LINE__);
+    tester.AssertEqual(ints.Ints()[1], -2, "TestParsePackedArrays", __LINE__);
+
+    const JSONArray& doubles = obj["doubles"];
+    tester.AssertEqual(doubles.GetStorage() == JSONArray::Storage::DOUBLES, true, "TestParsePackedArrays", __LINE__);
+    tester.AssertEqual(doubles.Doubles()[1], -2.25, "TestParsePackedArrays", __LINE__);
+
+    const JSONArray& mixed = obj["mixed"];
+    tester.AssertEqual(mixed.GetStorage() == JSONArray::Storage::GENERIC, true, "TestParsePackedArrays", __LINE__);
+    tester.AssertEqual(mixed.Size(), (u64)2, "TestParsePackedArrays", __LINE__);
+}
+
+void TestSerializeRoundTrip(Tester& tester)
+{
+    JSONParser parser;
+    JSONObject obj = parser.Parse("{\"pairs\":[{\"x0\":-24.136337,\"y0\":75.754684}, {\"x0\":25.535736,\"y0\":-43.788517}], \"ids\": [1, 2, 3], \"name\": \"haversine\", \"nested\": {\"n\": 1.5}}");
+
+    JSONSerializer compact;
+    compact.Write(obj);
+    JSONObject from_compact = parser.Parse(compact.Str());
+    tester.AssertEqual(from_compact == obj, true, "TestSerializeRoundTrip", __LINE__);
+
+    JSONSerializer pretty(JSONSerializer::Style::PRETTY);
+    pretty.Write(obj);
+    JSONObject from_pretty = parser.Parse(pretty.Str());
+    tester.AssertEqual(from_pretty == obj, true, "TestSerializeRoundTrip", __LINE__);
+
+    JSONObject escaped;
+    escaped.Put("quote", std::string("say \"hi\""));
+    escaped.Put("back\\slash", std::string("C:\\dir\\"));
+    escaped.Put("lines", std::string("one\ntwo\tthree\r\b\f"));
+    escaped.Put("control", std::string("\x01\x1f"));
+    escaped.Put("utf8", std::string("caf\xc3\xa9"));
+    JSONSerializer escaped_compact;
+    escaped_compact.Write(escaped);
+    JSONObject from_escaped = parser.Parse(escaped_compact.Str());
+    tester.AssertEqual(from_escaped == escaped, true, "TestSerializeRoundTrip", __LINE__);
+
+    JSONObject unicode = parser.Parse("{ \"s\": \"\\u00e9\\u20ac\\ud83d\\ude00\\/\" }");
+    tester.AssertEqual((std::string)unicode["s"], std::string("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80/"), 
+                       "TestSerializeRoundTrip", __LINE__);
+}
+
+void TestDoubleRoundTrip(Tester& tester)
+{
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<f64> coord_dist(-180.0, 180.0);
+
+    JSONArray coords(JSONArray::Storage::DOUBLES);
+    JSONArray any_bits(JSONArray::Storage::DOUBLES);
+    for (u64 index = 0; index < 10000; ++index)
+    {
+        coords.PushBack(coord_dist(rng));
+
+        // NOTE(19.10.26): random bit patterns cover subnormals and huge exponents
+        u64 bits = rng();
+        f64 num;
+        std::memcpy(&num, &bits, sizeof(num));
+        if (std::isfinite(num))
+        {
+            any_bits.PushBack(num);
+        }
+    }
+
+    JSONObject obj;
+    obj.Put("coords", std::move(coords));
+    obj.Put("bits", std::move(any_bits));
+
+    JSONSerializer serializer;
+    serializer.Write(obj);
+
+    JSONParser parser;
+    JSONObject parsed = parser.Parse(serializer.Str());
+
+    for (const char *key : {"coords", "bits"})
+    {
+        const JSONArray& expected = obj[key];
+        const JSONArray& actual = parsed[key];
+        tester.AssertEqual(actual.Size(), expected.Size(), "TestDoubleRoundTrip", __LINE__);
+        
+        u64 num_exact = 0;
+        for (u64 index = 0; index < expected.Size() && index < actual.Size(); ++index)
+        {
+            f64 expected_num = expected.Doubles()[index];
+            f64 actual_num = actual.Doubles()[index];
+            num_exact += std::memcmp(&expected_num, &actual_num, sizeof(f64)) == 0;
+        }
+        tester.AssertEqual(num_exact, expected.Size(), "TestDoubleRoundTrip", __LINE__);
+    }
+}
+
+void TestParseDedup(Tester& tester)
+{
+    std::string json_str = "{\"items\": [";
+    for (u32 index = 0; index < 100; ++index)
+    {
+        json_str += index ? ", " : "";
+        json_str += "{\"status\": \"active\", \"country\": \"DE\", \"tags\": [1, 2, 3]}";
+    }
+    json_str += "], \"other\": {\"status\": \"active\", \"country\": \"FR\", \"tags\": [1, 2, 3]}}";
+
+    JSONParser parser;
+    JSONObject plain = parser.Parse(json_str);
+
+    Deduplicator dedup;
+    JSONObject deduped = parser.Parse(json_str, dedup);
+    tester.AssertEqual(deduped == plain, true, "TestParseDedup", __LINE__);
+
+    // 99 repeated items, 99 + 1 repeated tag arrays
+    const Deduplicator::Stats& stats = dedup.GetStats();
+    tester.AssertEqual(stats.containers_shared, (u64)(99 + 100), "TestParseDedup", __LINE__);
+    tester.AssertEqual(stats.bytes_saved > 0, true, "TestParseDedup", __LINE__);
+
+    JSONArray& items = deduped["items"].json_arr;
+    const JSONArray& const_items = items;
+    tester.AssertEqual(&const_items.At(0)["status"] == &const_items.At(99)["status"], true, "TestParseDedup", __LINE__);
+
+    dedup.Clear();
+    (*items.At(0).json_val)["status"] = std::string("inactive");
+    tester.AssertEqual(items.At(0)["status"].str_val == "inactive", true, "TestParseDedup", __LINE__);
+    tester.AssertEqual(items.At(1)["status"].str_val == "active", true, "TestParseDedup", __LINE__);
+}
+
+void TestParsePatch(Tester& tester)
+{
+    JSONParser parser;
+    JSONObject doc = parser.Parse("{\"foo\": {\"bar\": \"baz\", \"waldo\": \"fred\"}, "
+                                  "\"qux\": {\"corge\": \"grault\"}, \"nums\": [1, 2, 3]}");
+    JSONObject patch_doc = parser.Parse("{\"patch\": ["
+        "{\"op\": \"move\", \"from\": \"/foo/waldo\", \"path\": \"/qux/thud\"}, "
+        "{\"op\": \"copy\", \"from\": \"/qux/corge\", \"path\": \"/foo/corge\"}, "
+        "{\"op\": \"add\", \"path\": \"/nums/-\", \"value\": 4}, "
+        "{\"op\": \"replace\", \"path\": \"/nums/0\", \"value\": 0}, "
+        "{\"op\": \"test\", \"path\": \"/qux/thud\", \"value\": \"fred\"}]}");
+    JSONObject expected = parser.Parse("{\"foo\": {\"bar\": \"baz\", \"corge\": \"grault\"}, "
+                                       "\"qux\": {\"corge\": \"grault\", \"thud\": \"fred\"}, "
+                                       "\"nums\": [0, 2, 3, 4]}");
+
+    JSONObject original = doc;
+    tester.AssertEqual(JSONPatch::Apply(doc, patch_doc["patch"]), true, "TestParsePatch", __LINE__);
+    tester.AssertEqual(doc == expected, true, "TestParsePatch", __LINE__);
+
+    // NOTE(19.10.26): documents parsed separately share no bodies, the diff goes by hashes
+    JSONArray patch = JSONPatch::Diff(original, expected);
+    JSONObject wrapped;
+    wrapped.Put("patch", patch);
+    JSONSerializer serializer;
+    serializer.Write(wrapped);
+    JSONObject reparsed = parser.Parse(serializer.Str());
+    tester.AssertEqual(JSONPatch::Apply(original, reparsed["patch"]), true, "TestParsePatch", __LINE__);
+    tester.AssertEqual(original == expected, true, "TestParsePatch", __LINE__);
+}
+
 void TestRealJson_Lex(Tester& tester)
 {
     JSONParser parser;